@@ -5,25 +5,58 @@
 #include "ssd1306/ssd1306.h"
 #include "ssd1306/ssd1306_tests.h"
 #include "touchpad.h"
+#include "contact.h"
+#include "predict.h"
+
+static contact_Tracker contact; // debounced finger state for the absolute mode
+static predict_State predictor; // moves the drawn circle to where the finger will be when it's visible
+
+static bool cursorDrawn = false; // the XOR cursor of dispMovement() is in the screenbuffer, cleared by full redraws
+
+#define LOG_HOLD_MS 2000 // the frames stay paused this long after a log message
+static uint32_t logTime;
+
+// Messages scroll up in the text console of the display, each one is sent as a single page
+static void logLine(const char *str)
+{
+    if (!ssd1306_ConsoleIsActive())
+        ssd1306_ConsoleBegin(&Font_6x8); // shows the previous lines again
+    ssd1306_ConsolePrint(str);
+    logTime = HAL_GetTick();
+}
+
+// True while the log is on the screen, afterwards the console is left and the frame is sent in full
+static bool logShowing()
+{
+    if (!ssd1306_ConsoleIsActive())
+        return false;
+    if ((HAL_GetTick() - logTime) < LOG_HOLD_MS)
+        return true;
+    ssd1306_ConsoleEnd();
+    return false;
+}
+
+extern TIM_HandleTypeDef htim6;
+
+// STM32's HAL TIM callback, TIM6 sets the touchpad polling period in remote mode
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM6)
+        touchpad_remotePoll();
+}
 
 void displayPS2Error(int8_t err)
 {
     char str[60];
     sprintf(str, "PS/2 Error: %d", err);
-    ssd1306_Fill(Black);
-    ssd1306_SetCursor(0, 0);
-    ssd1306_WriteString(str, Font_6x8, White);
-    ssd1306_UpdateScreen();
+    logLine(str);
     printf("PS/2 Error: %d", err);
     HAL_Delay(500);
 }
 
 void displayLog(char *msg)
 {
-    ssd1306_Fill(Black);
-    ssd1306_SetCursor(0, 0);
-    ssd1306_WriteString(msg, Font_6x8, White);
-    ssd1306_UpdateScreen();
+    logLine(msg);
     printf("%s\r\n", msg);
 }
 
@@ -31,11 +64,11 @@ void dispMovement()
 {
     static int16_t px = 20; // cursor current position
     static int16_t py = 20;
-    static const int16_t xmux = 1; // cursor speed calibration
-    static const int16_t ymux = 2;
-    int16_t vx = 0, vy = 0;  //cursor current speed
+    static const int16_t xmux = 2; // cursor speed calibration (for eResolution8cpmm)
+    static const int16_t ymux = 4;
+    touchpad_Movement mv;    // cursor movement since the previous frame
 
-    int8_t err = touchapd_readMovement(&vx, &vy, NULL);
+    int8_t err = touchpad_readAccumulatedMovement(&mv);
     if (err < TOUCHPAD_CORRUPT_DATA_ERROR) // report heavy errors
     {
         displayPS2Error(err);
@@ -44,17 +77,8 @@ void dispMovement()
     if (err != 0) // ignore a bit more frequent errors
         return;   // for example: FIFO empty (still waiting for data) or data corrupted (due to noise on data lines)
 
-    ssd1306_Fill(Black);
-    char str[20];
-    sprintf(str, "X: %d", vx);
-    ssd1306_SetCursor(0, 0);
-    ssd1306_WriteString(str, Font_6x8, White);
-    sprintf(str, "Y:  %d", vy);
-    ssd1306_SetCursor(64, 0);
-    ssd1306_WriteString(str, Font_6x8, White);
-
-    px += vx; // apply movement to cursor position
-    py -= vy; // cursor y position mirror
+    px += mv.dx; // apply movement to cursor position
+    py -= mv.dy; // cursor y position mirror
     if (px < 0)
         px = 0;
     if (py < 0)
@@ -63,40 +87,86 @@ void dispMovement()
         py = SSD1306_HEIGHT * ymux - 1;
     if (px > SSD1306_WIDTH * xmux)
         px = SSD1306_WIDTH * xmux - 1;
-    ssd1306_DrawPixel(px / xmux, py / ymux, White);
-    ssd1306_UpdateScreen();
+
+    // 5x5 crosshair, page-major: one byte per column
+    static const uint8_t cursor[] = {0x04, 0x04, 0x1B, 0x04, 0x04};
+    static int16_t cx, cy; // where the cursor was drawn
+
+    if (logShowing()) // the movement is already applied, the cursor catches up when the log is gone
+        return;
+    // back buffer, the previous frame may still be on the bus
+    if (cursorDrawn) // XOR again to erase the cursor, the rest of the frame stays
+        ssd1306_DrawBitmap(cx - 2, cy - 2, cursor, 5, 5, SSD1306_ROP_XOR);
+    else
+        ssd1306_Fill(Black);
+    ssd1306_FillRectangle(0, 0, SSD1306_WIDTH - 1, 7, Black); // only the text line is redrawn
+    char str[20];
+    sprintf(str, "X: %d", mv.dx);
+    ssd1306_SetCursor(0, 0);
+    ssd1306_WriteString(str, Font_6x8, White);
+    sprintf(str, "Y:  %d", mv.dy);
+    ssd1306_SetCursor(64, 0);
+    ssd1306_WriteString(str, Font_6x8, White);
+    cx = px / xmux;
+    cy = py / ymux;
+    ssd1306_DrawBitmap(cx - 2, cy - 2, cursor, 5, 5, SSD1306_ROP_XOR); // stays visible over the text
+    cursorDrawn = true;
 }
 
 void dispAbsolute()
 {
-    uint16_t px, py;  // touch x and y position
-    uint8_t pr;       // touch pressure
-    int8_t err = touchapd_readAbsolutePosition(&px, &py, &pr);
+    static uint16_t px, py; // touch x and y position of the last packet
+    static uint8_t pr;      // touch pressure
+    static const char *stateName[] = {"", "hover", "touch", "lift"};
+    uint16_t x, y;
+    uint8_t z;
+    int8_t err = touchapd_readAbsolutePosition(&x, &y, &z);
     if (err < TOUCHPAD_CORRUPT_DATA_ERROR) // report heavy errors
     {
         displayPS2Error(err);
         return;
     }
-    if (err != 0) // ignore a bit more frequent errors
-        return;   // for example: FIFO empty (still waiting for data) or data corrupted (due to noise on data lines)
+    if (err == 0) // packets only feed the contact state and the predictor
+    {
+        px = x;
+        py = y;
+        pr = z;
+        if (contact_update(&contact, px, py, pr, HAL_GetTick(), NULL) == eContactTouchUp)
+            predict_reset(&predictor);
+        if (contact_getState(&contact) == eContactTouching)
+            predict_addSample(&predictor, px, py, touchpad_getPacketTimestamp());
+    }
+    else // ignore a bit more frequent errors, for example: FIFO empty (still waiting for data) or data corrupted (due to noise on data lines)
+    {
+        if (contact_poll(&contact, HAL_GetTick(), NULL) == eContactTouchUp) // finish the lift if the device went silent
+            predict_reset(&predictor);
+    }
 
+    // the frame is drawn on every call, between packets the circle follows the prediction
+    if (logShowing())
+        return;
     ssd1306_Fill(Black);
-    char str[20];
+    cursorDrawn = false;
+    char str[24];
     sprintf(str, "X: %d", px);
     ssd1306_SetCursor(0, 0);
     ssd1306_WriteString(str, Font_6x8, White);
     sprintf(str, "Y:  %d", py);
     ssd1306_SetCursor(64, 0);
     ssd1306_WriteString(str, Font_6x8, White);
-    sprintf(str, "Pressure: %d", pr);
+    sprintf(str, "Pressure: %d %s", pr, stateName[contact_getState(&contact)]);
     ssd1306_SetCursor(0, 9);
     ssd1306_WriteString(str, Font_6x8, White);
 
-    px = (px - 1115) / 36;           // apply calibration values
-    py = SSD1306_HEIGHT - (py - 792) / 134;      // this depends on your display resolution
-    pr = pr / 15;                    // you can experiment with theese values to choose best fit
-    ssd1306_DrawCircle(px, py, pr, White);
-    ssd1306_UpdateScreen();
+    static uint32_t updateTime = 0; // how long the previous frame took to reach the display
+    uint16_t cx = px, cy = py;
+    predict_getPosition(&predictor, HAL_GetTick() + updateTime, &cx, &cy);
+    cx = (cx - 1115) / 36;           // apply calibration values
+    cy = SSD1306_HEIGHT - (cy - 792) / 134;      // this depends on your display resolution
+    uint8_t r = pr / 15;             // you can experiment with theese values to choose best fit
+    if (contact_getState(&contact) >= eContactTouching) // hovering finger is not a touch
+        ssd1306_DrawCircle(cx, cy, r, White);
+    updateTime = (ssd1306_GetUpdateStats().TimeUs + 999) / 1000; // transfer time of the previous frame
 }
 
 void main_app()
@@ -104,6 +174,8 @@ void main_app()
     // ssd1306_TestAll();
     ssd1306_Init();
     displayLog("OLED init OK");
+    contact_init(&contact, NULL);
+    predict_init(&predictor, 50, 100); // predict up to 50ms ahead, only from packets at most 100ms apart
 
     int8_t err = touchapd_init();
     if (err)
@@ -112,6 +184,12 @@ void main_app()
         displayLog("TP init OK");
     HAL_Delay(500);
 
+    // finer resolution and device side acceleration instead of scaling the movement up in dispMovement()
+    static const touchpad_Config movementConfig = {eResolution8cpmm, eScaling2to1, eSampleRate100fps};
+    err = touchpad_beginConfig(&movementConfig); // finished by touchpad_processCommands() in the main loop
+    if (err)
+        displayPS2Error(err - 60);
+
     /* // Uncomment to test addiional features 
 
     err = touchpad_setMode(eAbsoluteMode);
@@ -121,6 +199,15 @@ void main_app()
         displayLog("TP absolute OK");
     HAL_Delay(500);
 
+    // lowest latency: 80 packets/s and no tap detection in the touchpad firmware
+    static const touchpad_SynapticsMode fastAbsolute = {.absolute = true, .highRate = true, .disableGestures = true};
+    err = touchpad_setSynapticsMode(&fastAbsolute);
+    if (err)
+        displayPS2Error(err - 70);
+    else
+        displayLog("TP fast absolute OK");
+    HAL_Delay(500);
+
     err = touchapd_setSampleRate(eSampleRate10fps);
     if (err)
         displayPS2Error(err - 40);
@@ -128,26 +215,55 @@ void main_app()
         displayLog("TP sample rate OK");
     HAL_Delay(500);
 
+    err = touchpad_setReportingMode(eRemoteReporting); // packets at the TIM6 period instead of the sample rate
+    if (err)
+        displayPS2Error(err - 50);
+    else
+        displayLog("TP remote mode OK");
+    HAL_TIM_Base_Start_IT(&htim6);
+    HAL_Delay(500);
+
     */
 
+    bool buttonWasPressed = false;
+    bool modeSwitchRequested = false; // retried while a command transaction is still running
+    uint32_t buttonTime = 0;
     while (1)
     {
+        err = touchpad_processCommands();
+        if ((err != TOUCHPAD_OK) && (err != TOUCHPAD_BUSY))
+            displayPS2Error(err - 60);
         if (touchpad_getCurrentMode() == eMovementMode)
             dispMovement();
         if (touchpad_getCurrentMode() == eAbsoluteMode)
             dispAbsolute();
+        ssd1306_Present(); // sends the changed bytes of the last drawn frame, the main loop continues during the transfer
+
+        bool pressed = (HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0) == GPIO_PIN_SET); // check user button
+        if (pressed && !buttonWasPressed && ((HAL_GetTick() - buttonTime) > 200)) // 200ms debounce without blocking
+        {
+            buttonTime = HAL_GetTick();
+            modeSwitchRequested = true;
+        }
+        buttonWasPressed = pressed;
 
-        if (HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0) == GPIO_PIN_SET) // check user button
+        if (modeSwitchRequested)
         {
             if (touchpad_getCurrentMode() == eMovementMode) //change mode after pressing button
                 err = touchpad_setMode(eAbsoluteMode);
             else
                 err = touchpad_setMode(eMovementMode);
+            if (err == TOUCHPAD_BUSY)
+                continue; // the configuration is still being sent
+            modeSwitchRequested = false;
             if (err)
                 displayPS2Error(err - 30);
             else
-                displayLog("TP mode set OK");
-            HAL_Delay(300);
+            {
+                char str[24];
+                sprintf(str, "TP mode set OK %lums", (unsigned long)touchpad_getModeSwitchTime());
+                displayLog(str);
+            }
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+Converts the row-major fonts of ssd1306_fonts.c into page-major tables.
+
+Every glyph is stored as ceil(height / 8) pages of `width` column bytes,
+bit 0 being the top pixel, the same layout as the SSD1306 display RAM, so
+ssd1306_WriteChar() copies the columns without any bit transposition.
+With --chars only the listed glyphs are kept (plus a 95 byte index map).
+
+Usage:
+    python3 fontgen.py [ssd1306_fonts.c] [-o ssd1306_fonts_paged.c] [--chars "0123456789 XY:"] [--check]
+
+Enable the output with #define SSD1306_USE_PAGED_FONTS in ssd1306_conf.h.
+
+The conversion is a manual step, the firmware build only compiles the
+generated file. Rerun the script after editing ssd1306_fonts.c; --check
+(with the same --chars) writes nothing and fails if the output is stale,
+e.g. as a pre-build step of the IDE or in CI.
+"""
+
+import argparse
+import re
+import sys
+
+FIRST_CHAR = 32
+GLYPHS = 95  # ' ' .. '~'
+
+
+def parse_fonts(source):
+    source = re.sub(r'//[^\n]*', '', source)
+    fonts = []
+    for m in re.finditer(r'static const uint16_t Font(\d+)x(\d+)\s*\[\]\s*=\s*\{(.*?)\};', source, re.S):
+        width, height = int(m.group(1)), int(m.group(2))
+        rows = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]+', m.group(3))]
+        if len(rows) != GLYPHS * height:
+            sys.exit('Font%dx%d: expected %d rows, found %d' % (width, height, GLYPHS * height, len(rows)))
+        fonts.append((width, height, rows))
+    return fonts
+
+
+def paged_glyph(rows, width, height, index):
+    pages = (height + 7) // 8
+    glyph = rows[index * height:(index + 1) * height]
+    out = []
+    for page in range(pages):
+        for col in range(width):
+            byte = 0
+            for bit in range(8):
+                row = page * 8 + bit
+                if row < height and (glyph[row] << col) & 0x8000:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def glyph_comment(index):
+    ch = chr(FIRST_CHAR + index)
+    return 'sp' if ch == ' ' else ch
+
+
+def generate(fonts, chars):
+    keep = list(range(GLYPHS))
+    if chars is not None:
+        keep = sorted({ord(c) - FIRST_CHAR for c in chars if FIRST_CHAR <= ord(c) < FIRST_CHAR + GLYPHS})
+
+    lines = [
+        '// Generated by fontgen.py from ssd1306_fonts.c, do not edit.',
+        '// Page-major glyphs: ceil(height / 8) pages of width column bytes, bit 0 = top pixel.',
+        '',
+        '#include <stddef.h>',
+        '#include "ssd1306_fonts.h"',
+        '',
+        '#ifdef SSD1306_USE_PAGED_FONTS',
+    ]
+    report = []
+    for width, height, rows in fonts:
+        name = 'Font%dx%d' % (width, height)
+        lines += ['', '#ifdef SSD1306_INCLUDE_FONT_%dx%d' % (width, height),
+                  'static const uint8_t %s_paged [] = {' % name]
+        for index in keep:
+            data = paged_glyph(rows, width, height, index)
+            comment = glyph_comment(index)
+            comment = ' /* \\ */' if comment == '\\' else ' // ' + comment  # a backslash would continue the line comment
+            lines.append(''.join('0x%02X, ' % b for b in data) + comment)
+        lines.append('};')
+
+        map_name = 'NULL'
+        map_size = 0
+        if chars is not None:
+            glyph_map = [0xFF] * GLYPHS
+            for n, index in enumerate(keep):
+                glyph_map[index] = n
+            map_name = '%s_map' % name
+            map_size = GLYPHS
+            lines.append('static const uint8_t %s [] = { // ch - 32 -> glyph, 0xFF = not included' % map_name)
+            for i in range(0, GLYPHS, 16):
+                lines.append(''.join('0x%02X, ' % b for b in glyph_map[i:i + 16]).rstrip())
+            lines.append('};')
+
+        lines.append('FontDef Font_%dx%d = {%d,%d,NULL,%s_paged,%s};' % (width, height, width, height, name, map_name))
+        lines.append('#endif')
+
+        before = GLYPHS * height * 2
+        after = len(keep) * ((height + 7) // 8) * width + map_size
+        report.append('%-10s %3d glyphs  %5d -> %5d bytes  (%+d)' % (name, len(keep), before, after, after - before))
+
+    lines += ['', '#endif // SSD1306_USE_PAGED_FONTS', '']
+    return '\n'.join(lines), report
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('source', nargs='?', default='ssd1306_fonts.c')
+    parser.add_argument('-o', '--output', default='ssd1306_fonts_paged.c')
+    parser.add_argument('--chars', help='keep only these characters (default: all 95)')
+    parser.add_argument('--check', action='store_true', help='only verify that the output is up to date')
+    args = parser.parse_args()
+
+    with open(args.source) as f:
+        fonts = parse_fonts(f.read())
+    if not fonts:
+        sys.exit('no fonts found in ' + args.source)
+
+    output, report = generate(fonts, args.chars)
+    if args.check:
+        try:
+            with open(args.output) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != output:
+            sys.exit('%s is out of date, rerun fontgen.py' % args.output)
+        print('%s is up to date' % args.output)
+        return
+
+    with open(args.output, 'w') as f:
+        f.write(output)
+    print('flash used by the glyph tables (row-major -> page-major):')
+    print('\n'.join(report))
+
+
+if __name__ == '__main__':
+    main()
@@ -1,24 +1,87 @@
 #include "ssd1306.h"
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>  // For memcpy
 
+// Bus usage counters, reset by ssd1306_UpdateScreen()
+static SSD1306_UpdateStats_t SSD1306_Stats;
+
+// Set while a DMA update is in flight, the screenbuffer must not change meanwhile
+static volatile uint8_t SSD1306_Busy = 0;
+
+static void ssd1306_WaitReady(void) {
+    while(SSD1306_Busy) {
+        // the previous asynchronous update is still on the bus
+    }
+}
+
+// Called before the screenbuffer is modified. With a single buffer the DMA reads it
+// directly, so drawing waits for the transfer instead of tearing the frame.
+static inline void ssd1306_WaitDrawable(void) {
+#if !defined(SSD1306_USE_DOUBLE_BUFFER)
+    ssd1306_WaitReady();
+#endif
+}
+
+#if defined(SSD1306_USE_DMA)
+static HAL_StatusTypeDef ssd1306_AsyncNext(void);
+static void ssd1306_AsyncAbort(void);
+#endif
+
 #if defined(SSD1306_USE_I2C)
 
+// address and control byte of every transaction
+#define SSD1306_TRANSACTION_OVERHEAD 2
+
 void ssd1306_Reset(void) {
     /* for I2C - do nothing */
 }
 
 // Send a byte to the command register
 void ssd1306_WriteCommand(uint8_t byte) {
-    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, &byte, 1, HAL_MAX_DELAY);
+    ssd1306_WriteCommands(&byte, 1);
+}
+
+// Send several command bytes in one transaction
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t len) {
+    ssd1306_WaitReady();
+    SSD1306_Stats.Bytes += len + SSD1306_TRANSACTION_OVERHEAD;
+    SSD1306_Stats.Transactions++;
+    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, (uint8_t *) cmds, len, HAL_MAX_DELAY);
 }
 
 // Send data
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
+    ssd1306_WaitReady();
+    SSD1306_Stats.Bytes += buff_size + SSD1306_TRANSACTION_OVERHEAD;
+    SSD1306_Stats.Transactions++;
     HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x40, 1, buffer, buff_size, HAL_MAX_DELAY);
 }
 
+#if defined(SSD1306_USE_DMA)
+
+// Start sending commands (is_data = 0) or data by DMA, completion calls ssd1306_AsyncNext()
+static HAL_StatusTypeDef ssd1306_TransmitDMA(uint8_t is_data, uint8_t* buffer, size_t len) {
+    SSD1306_Stats.Bytes += len + SSD1306_TRANSACTION_OVERHEAD;
+    SSD1306_Stats.Transactions++;
+    return HAL_I2C_Mem_Write_DMA(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, is_data ? 0x40 : 0x00, 1, buffer, len);
+}
+
+// STM32's HAL I2C callback, called by the HAL_I2C_EV_IRQHandler when the DMA transfer is finished
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if(hi2c == &SSD1306_I2C_PORT) {
+        ssd1306_AsyncNext();
+    }
+}
+
+// STM32's HAL I2C callback, e.g. the display did not acknowledge
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if(hi2c == &SSD1306_I2C_PORT) {
+        ssd1306_AsyncAbort();
+    }
+}
+
+#endif // SSD1306_USE_DMA
+
 #elif defined(SSD1306_USE_SPI)
 
 void ssd1306_Reset(void) {
@@ -34,36 +97,140 @@ void ssd1306_Reset(void) {
 
 // Send a byte to the command register
 void ssd1306_WriteCommand(uint8_t byte) {
+    ssd1306_WriteCommands(&byte, 1);
+}
+
+// Send several command bytes in one transaction
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t len) {
+    ssd1306_WaitReady();
+    SSD1306_Stats.Bytes += len;
+    SSD1306_Stats.Transactions++;
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
     HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_RESET); // command
-    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) &byte, 1, HAL_MAX_DELAY);
+    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) cmds, len, HAL_MAX_DELAY);
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
 }
 
 // Send data
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
+    ssd1306_WaitReady();
+    SSD1306_Stats.Bytes += buff_size;
+    SSD1306_Stats.Transactions++;
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
     HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_SET); // data
     HAL_SPI_Transmit(&SSD1306_SPI_PORT, buffer, buff_size, HAL_MAX_DELAY);
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
 }
 
+#if defined(SSD1306_USE_DMA)
+
+// Start sending commands (is_data = 0) or data by DMA, completion calls ssd1306_AsyncNext()
+static HAL_StatusTypeDef ssd1306_TransmitDMA(uint8_t is_data, uint8_t* buffer, size_t len) {
+    SSD1306_Stats.Bytes += len;
+    SSD1306_Stats.Transactions++;
+    HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
+    HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, is_data ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    return HAL_SPI_Transmit_DMA(&SSD1306_SPI_PORT, buffer, len);
+}
+
+// STM32's HAL SPI callback, called by the DMA interrupt when the transfer is finished
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+    if(hspi == &SSD1306_SPI_PORT) {
+        HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
+        ssd1306_AsyncNext();
+    }
+}
+
+#endif // SSD1306_USE_DMA
+
 #else
 #error "You should define SSD1306_USE_SPI or SSD1306_USE_I2C macro"
 #endif
 
 
-// Screenbuffer
-static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE];
+// Screenbuffer, aligned to the 32 byte cache lines for the DMA
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+static uint8_t SSD1306_Buffers[2][SSD1306_BUFFER_SIZE] __ALIGNED(32);
+static uint8_t* SSD1306_Buffer = SSD1306_Buffers[0]; // drawing (back) buffer
+static uint8_t* SSD1306_Front = SSD1306_Buffers[1];  // what the display shows (or is receiving)
+static uint8_t SSD1306_FrontValid = 0;               // 0 after a failed transfer, the diff can't be trusted
+#else
+static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE] __ALIGNED(32);
+#endif
 
 // Screen object
 static SSD1306_t SSD1306;
 
+// Display RAM of the controller, 8 pages also behind a 32 pixel high panel
+#define SSD1306_RAM_PAGES 8
+
+// Text console, one line per RAM page used as a ring, the start line selects the visible pages
+static struct {
+    const FontDef* Font;
+    uint8_t Active;
+    uint8_t Page;  // RAM page of the next line
+    uint8_t Lines; // written lines, saturates once the screen is full
+} SSD1306_Console;
+
+// Changed columns of every page since the last update, clean when Min > Max
+static uint8_t SSD1306_DirtyMin[SSD1306_HEIGHT/8];
+static uint8_t SSD1306_DirtyMax[SSD1306_HEIGHT/8];
+
+static inline void ssd1306_MarkDirty(uint8_t x, uint8_t page) {
+    if(x < SSD1306_DirtyMin[page]) SSD1306_DirtyMin[page] = x;
+    if(x > SSD1306_DirtyMax[page]) SSD1306_DirtyMax[page] = x;
+}
+
+static void ssd1306_MarkAllDirty(void) {
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        SSD1306_DirtyMin[i] = 0;
+        SSD1306_DirtyMax[i] = SSD1306_WIDTH - 1;
+    }
+}
+
+static void ssd1306_MarkAllClean(void) {
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        SSD1306_DirtyMin[i] = 0xFF;
+        SSD1306_DirtyMax[i] = 0;
+    }
+}
+
+// Microsecond time stamps for the update statistics. The cycle counter may
+// be shared with other profiling code, so it is only enabled, never reset.
+static void ssd1306_StartTimer(void) {
+#ifdef DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(STM32F7)
+    DWT->LAR = 0xC5ACCE55; // Cortex-M7 locks the DWT registers after reset
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static uint32_t ssd1306_Timestamp(void) {
+#ifdef DWT
+    return DWT->CYCCNT;
+#else
+    return HAL_GetTick();
+#endif
+}
+
+static uint32_t ssd1306_ElapsedUs(uint32_t start) {
+    uint32_t elapsed = ssd1306_Timestamp() - start;
+#ifdef DWT
+    return elapsed / (SystemCoreClock / 1000000);
+#else
+    return elapsed * 1000;
+#endif
+}
+
 /* Fills the Screenbuffer with values from a given buffer of a fixed length */
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len) {
     SSD1306_Error_t ret = SSD1306_ERR;
     if (len <= SSD1306_BUFFER_SIZE) {
+        ssd1306_WaitDrawable();
         memcpy(SSD1306_Buffer,buf,len);
+        ssd1306_MarkAllDirty();
         ret = SSD1306_OK;
     }
     return ret;
@@ -71,6 +238,8 @@ SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len) {
 
 // Initialize the oled screen
 void ssd1306_Init(void) {
+    ssd1306_StartTimer();
+
     // Reset OLED
     ssd1306_Reset();
 
@@ -161,7 +330,8 @@ void ssd1306_Init(void) {
     // Clear screen
     ssd1306_Fill(Black);
     
-    // Flush buffer to screen
+    // Flush buffer to screen, the display RAM holds random data after power up
+    ssd1306_MarkAllDirty();
     ssd1306_UpdateScreen();
     
     // Set default values for screen object
@@ -174,29 +344,319 @@ void ssd1306_Init(void) {
 // Fill the whole screen with the given color
 void ssd1306_Fill(SSD1306_COLOR color) {
     /* Set memory */
-    uint32_t i;
+    uint32_t value = (color == Black) ? 0x00000000 : 0xFFFFFFFF;
+
+    ssd1306_WaitDrawable();
+
+    for(uint8_t page = 0; page < SSD1306_HEIGHT/8; page++) {
+        uint8_t* row = &SSD1306_Buffer[SSD1306_WIDTH*page];
+        int16_t first = -1;
+        int16_t last = -1;
+        uint8_t x = 0;
+
+        // Bytes up to the first word boundary, e.g. on 130 pixel wide screens
+        for(; x < SSD1306_WIDTH && ((uintptr_t)&row[x] & 3); x++) {
+            if(row[x] != (uint8_t)value) {
+                row[x] = value;
+                if(first < 0) {
+                    first = x;
+                }
+                last = x;
+            }
+        }
+        // Whole words, memcpy keeps the byte buffer free of aliasing and compiles to single loads and stores
+        for(; x + 4 <= SSD1306_WIDTH; x += 4) {
+            uint32_t word;
+            memcpy(&word, &row[x], sizeof(word));
+            uint32_t diff = word ^ value;
+            if(diff) {
+                memcpy(&row[x], &value, sizeof(value));
+                // Little endian, the lowest byte is the leftmost column
+                if(first < 0) {
+                    first = x + __builtin_ctz(diff) / 8;
+                }
+                last = x + 3 - __builtin_clz(diff) / 8;
+            }
+        }
+        for(; x < SSD1306_WIDTH; x++) {
+            if(row[x] != (uint8_t)value) {
+                row[x] = value;
+                if(first < 0) {
+                    first = x;
+                }
+                last = x;
+            }
+        }
 
-    for(i = 0; i < sizeof(SSD1306_Buffer); i++) {
-        SSD1306_Buffer[i] = (color == Black) ? 0x00 : 0xFF;
+        if(first >= 0) {
+            ssd1306_MarkDirty(first, page);
+            ssd1306_MarkDirty(last, page);
+        }
     }
 }
 
+// Transactions of the next update: a window command and a data block each
+static uint8_t SSD1306_Window[SSD1306_HEIGHT/8][32] __ALIGNED(32); // one cache line per window
+static uint8_t* SSD1306_SegmentData[SSD1306_HEIGHT/8];
+static uint16_t SSD1306_SegmentLength[SSD1306_HEIGHT/8];
+static SSD1306_UPDATE_MODE SSD1306_UpdateMode = SSD1306_UPDATE_AUTO;
+
+#if defined(SSD1306_USE_I2C)
+#define SSD1306_SEGMENT_COST (6 + 2 * SSD1306_TRANSACTION_OVERHEAD + 1) // window, overheads, start/stop bits
+#else
+#define SSD1306_SEGMENT_COST 6
+#endif
+
+static void ssd1306_AddSegment(uint8_t* source, uint8_t n, uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2) {
+    // Column and page window, horizontal addressing mode fills it from the top left
+    uint8_t* window = SSD1306_Window[n];
+    window[0] = 0x21;
+    window[1] = x1;
+    window[2] = x2;
+    window[3] = 0x22;
+    window[4] = page1;
+    window[5] = page2;
+    SSD1306_SegmentData[n] = &source[SSD1306_WIDTH*page1 + x1];
+    SSD1306_SegmentLength[n] = (page2 - page1) * SSD1306_WIDTH + (x2 - x1 + 1);
+}
+
+// Turns the dirty ranges into segments of the source buffer, returns their number
+static uint8_t ssd1306_PlanUpdate(uint8_t* source) {
+    uint8_t count = 0;
+    uint8_t first = 0xFF, last = 0;
+    uint32_t pagesCost = 0;
+
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        if(SSD1306_DirtyMin[i] > SSD1306_DirtyMax[i]) {
+            continue; // page unchanged
+        }
+        if(first == 0xFF) first = i;
+        last = i;
+        pagesCost += SSD1306_SEGMENT_COST + SSD1306_DirtyMax[i] - SSD1306_DirtyMin[i] + 1;
+    }
+    if(first == 0xFF) {
+        return 0;
+    }
+
+    // Full width rows are continuous in the buffer, so they fit in one data transaction
+    uint32_t frameCost = SSD1306_SEGMENT_COST + (last - first + 1) * SSD1306_WIDTH;
+    if((SSD1306_UpdateMode == SSD1306_UPDATE_FRAME) ||
+       ((SSD1306_UpdateMode == SSD1306_UPDATE_AUTO) && (frameCost <= pagesCost))) {
+        ssd1306_AddSegment(source, count++, 0, SSD1306_WIDTH - 1, first, last);
+    } else {
+        for(uint8_t i = first; i <= last; i++) {
+            if(SSD1306_DirtyMin[i] <= SSD1306_DirtyMax[i]) {
+                ssd1306_AddSegment(source, count++, SSD1306_DirtyMin[i], SSD1306_DirtyMax[i], i, i);
+            }
+        }
+    }
+    ssd1306_MarkAllClean();
+    return count;
+}
+
+void ssd1306_SetUpdateMode(SSD1306_UPDATE_MODE mode) {
+    SSD1306_UpdateMode = mode;
+}
+
+static void ssd1306_SendBlocking(uint8_t* source) {
+    uint32_t start = ssd1306_Timestamp();
+    SSD1306_Stats.Bytes = 0;
+    SSD1306_Stats.Transactions = 0;
+
+    uint8_t count = ssd1306_PlanUpdate(source);
+    for(uint8_t i = 0; i < count; i++) {
+        ssd1306_WriteCommands(SSD1306_Window[i], 6);
+        ssd1306_WriteData(SSD1306_SegmentData[i], SSD1306_SegmentLength[i]);
+    }
+
+    SSD1306_Stats.TimeUs = ssd1306_ElapsedUs(start);
+}
+
 // Write the screenbuffer with changed to the screen
 void ssd1306_UpdateScreen(void) {
-    // Write data to each page of RAM. Number of pages
+    // Write the changed part of the RAM. Number of pages
     // depends on the screen height:
     //
     //  * 32px   ==  4 pages
     //  * 64px   ==  8 pages
     //  * 128px  ==  16 pages
+    if(SSD1306_Console.Active) {
+        return; // the console owns the display RAM, everything is sent after ssd1306_ConsoleEnd()
+    }
+    ssd1306_WaitReady();
+    ssd1306_SendBlocking(SSD1306_Buffer);
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+    memcpy(SSD1306_Front, SSD1306_Buffer, SSD1306_BUFFER_SIZE);
+    SSD1306_FrontValid = 1;
+#endif
+}
+
+#if defined(SSD1306_USE_DMA)
+
+static uint8_t SSD1306_AsyncCount;
+static volatile uint8_t SSD1306_AsyncStep; // two steps per segment: window commands, then data
+static uint32_t SSD1306_AsyncStart;
+
+// Writes back the cached buffer, so the DMA reads what the CPU has drawn
+static void ssd1306_CleanCache(void* addr, uint32_t len) {
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr((uint32_t*)addr, len);
+#else
+    (void)addr;
+    (void)len;
+#endif
+}
+
+// Starts the next transfer of the update, HAL_OK also when the update is complete
+static HAL_StatusTypeDef ssd1306_AsyncNext(void) {
+    uint8_t step = SSD1306_AsyncStep++;
+    if(step >= 2 * SSD1306_AsyncCount) {
+        SSD1306_Stats.TimeUs = ssd1306_ElapsedUs(SSD1306_AsyncStart);
+        SSD1306_Busy = 0;
+        return HAL_OK;
+    }
+    uint8_t i = step / 2;
+    HAL_StatusTypeDef status;
+    if((step & 1) == 0) {
+        status = ssd1306_TransmitDMA(0, SSD1306_Window[i], 6);
+    } else {
+        status = ssd1306_TransmitDMA(1, SSD1306_SegmentData[i], SSD1306_SegmentLength[i]);
+    }
+    if(status != HAL_OK) {
+        ssd1306_AsyncAbort();
+    }
+    return status;
+}
+
+static void ssd1306_AsyncAbort(void) {
+    ssd1306_MarkAllDirty(); // the display content is unknown, send everything next time
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+    SSD1306_FrontValid = 0;
+#endif
+    SSD1306_Busy = 0;
+}
+
+// Send the changed part of the source buffer by DMA in the background
+static SSD1306_Error_t ssd1306_StartAsync(uint8_t* source) {
+    SSD1306_AsyncCount = ssd1306_PlanUpdate(source);
+    if(SSD1306_AsyncCount == 0) {
+        return SSD1306_OK;
+    }
+
+    ssd1306_CleanCache(SSD1306_Window, sizeof(SSD1306_Window));
+    ssd1306_CleanCache(source, SSD1306_BUFFER_SIZE);
+
+    SSD1306_Stats.Bytes = 0;
+    SSD1306_Stats.Transactions = 0;
+    SSD1306_AsyncStart = ssd1306_Timestamp();
+    SSD1306_AsyncStep = 0;
+    SSD1306_Busy = 1;
+    return (ssd1306_AsyncNext() == HAL_OK) ? SSD1306_OK : SSD1306_ERR;
+}
+
+#endif // SSD1306_USE_DMA
+
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+
+// Shrinks the dirty ranges to the bytes that really differ from the displayed frame,
+// e.g. ssd1306_Fill(Black) followed by drawing the same content again sends nothing
+static void ssd1306_DiffDirty(void) {
+    if(!SSD1306_FrontValid) {
+        return;
+    }
     for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
-        ssd1306_WriteCommand(0xB0 + i); // Set the current RAM page address.
-        ssd1306_WriteCommand(0x00);
-        ssd1306_WriteCommand(0x10);
-        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH*i],SSD1306_WIDTH);
+        uint8_t x1 = SSD1306_DirtyMin[i];
+        uint8_t x2 = SSD1306_DirtyMax[i];
+        const uint8_t* back = &SSD1306_Buffer[SSD1306_WIDTH*i];
+        const uint8_t* front = &SSD1306_Front[SSD1306_WIDTH*i];
+        while((x1 <= x2) && !(back[x1] ^ front[x1])) x1++;
+        while((x2 > x1) && !(back[x2] ^ front[x2])) x2--;
+        if(x1 > x2) {
+            SSD1306_DirtyMin[i] = 0xFF; // page unchanged
+            SSD1306_DirtyMax[i] = 0;
+        } else {
+            SSD1306_DirtyMin[i] = x1;
+            SSD1306_DirtyMax[i] = x2;
+        }
     }
 }
 
+// Swap the buffers and send the completed one, drawing of the next frame may start right away
+SSD1306_Error_t ssd1306_Present(void) {
+    if(SSD1306_Busy || SSD1306_Console.Active) {
+        return SSD1306_BUSY;
+    }
+    ssd1306_DiffDirty();
+    uint8_t changed = 0;
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        changed |= (SSD1306_DirtyMin[i] <= SSD1306_DirtyMax[i]);
+    }
+    if(!changed) {
+        return SSD1306_OK; // cheap enough to call every main loop iteration
+    }
+
+    uint8_t* completed = SSD1306_Buffer;
+    SSD1306_Buffer = SSD1306_Front;
+    SSD1306_Front = completed;
+    SSD1306_FrontValid = 1;
+    SSD1306_Error_t ret = SSD1306_OK;
+#if defined(SSD1306_USE_DMA)
+    ret = ssd1306_StartAsync(SSD1306_Front);
+#else
+    ssd1306_SendBlocking(SSD1306_Front);
+#endif
+
+    // The next frame starts from the presented one (the DMA only reads the front buffer)
+    memcpy(SSD1306_Buffer, SSD1306_Front, SSD1306_BUFFER_SIZE);
+    return ret;
+}
+
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void) {
+    return ssd1306_Present();
+}
+
+#elif defined(SSD1306_USE_DMA)
+
+// Queue the changed part of the screenbuffer and send it by DMA in the background
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void) {
+    if(SSD1306_Busy || SSD1306_Console.Active) {
+        return SSD1306_BUSY;
+    }
+    return ssd1306_StartAsync(SSD1306_Buffer);
+}
+
+SSD1306_Error_t ssd1306_Present(void) {
+    return ssd1306_UpdateScreenAsync();
+}
+
+#else
+
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void) {
+    ssd1306_UpdateScreen();
+    return SSD1306_OK;
+}
+
+SSD1306_Error_t ssd1306_Present(void) {
+    ssd1306_UpdateScreen();
+    return SSD1306_OK;
+}
+
+#endif // SSD1306_USE_DOUBLE_BUFFER
+
+uint8_t ssd1306_IsBusy(void) {
+    return SSD1306_Busy;
+}
+
+uint32_t ssd1306_EstimateTransferUs(uint32_t bytes, uint16_t transactions, uint32_t bus_hz) {
+#if defined(SSD1306_USE_I2C)
+    // 8 data bits and ACK per byte, start and stop conditions per transaction
+    uint64_t bits = (uint64_t)bytes * 9 + (uint64_t)transactions * 2;
+#else
+    uint64_t bits = (uint64_t)bytes * 8;
+#endif
+    return (uint32_t)((bits * 1000000) / bus_hz);
+}
+
 //    Draw one pixel in the screenbuffer
 //    X => X Coordinate
 //    Y => Y Coordinate
@@ -206,6 +666,7 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
         // Don't write outside the buffer
         return;
     }
+    ssd1306_WaitDrawable();
     
     // Check if pixel should be inverted
     if(SSD1306.Inverted) {
@@ -213,11 +674,79 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
     }
     
     // Draw in the right color
+    uint8_t* byte = &SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH];
+    uint8_t old = *byte;
     if(color == White) {
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
+        *byte |= 1 << (y % 8);
     } else { 
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+        *byte &= ~(1 << (y % 8));
+    }
+    if(*byte != old) {
+        ssd1306_MarkDirty(x, y / 8);
+    }
+}
+
+// Write up to 32 pixels of one column at once, page by page with shift and mask
+// x, y    => top pixel, the column has to fit on the screen
+// bits    => pixels, bit 0 is the top one
+// invert  => 1 draws the set bits Black and the rest White (ROP for colour and inversion)
+static void ssd1306_BlitColumn(uint8_t x, uint8_t y, uint32_t bits, uint8_t height, uint8_t invert) {
+    uint8_t shift = y % 8;
+    uint64_t mask = ((height < 32) ? ((1ULL << height) - 1) : 0xFFFFFFFFULL) << shift;
+    uint64_t value = ((uint64_t)(invert ? ~bits : bits) << shift) & mask;
+    uint8_t page = y / 8;
+    uint8_t* byte = &SSD1306_Buffer[x + page * SSD1306_WIDTH];
+
+    while(mask) {
+        uint8_t m = (uint8_t)mask;
+        uint8_t updated = (*byte & ~m) | ((uint8_t)value & m);
+        if(updated != *byte) {
+            *byte = updated;
+            ssd1306_MarkDirty(x, page);
+        }
+        mask >>= 8;
+        value >>= 8;
+        page++;
+        byte += SSD1306_WIDTH;
+    }
+}
+
+// Columns of a glyph in the layout of the display RAM, bit 0 = top row (fonts are at most 16 pixels wide)
+// Returns 0 if the font has no glyph for ch
+static uint8_t ssd1306_GlyphColumns(char ch, const FontDef* Font, uint32_t column[16]) {
+    uint32_t i, b, j;
+    
+    // Check if character is valid
+    if (ch < 32 || ch > 126)
+        return 0;
+    
+    if (Font->paged) {
+        // Page-major glyph, columns are already in the layout of the display RAM
+        uint32_t glyph = ch - 32;
+        if (Font->glyphMap) {
+            glyph = Font->glyphMap[glyph];
+            if (glyph == 0xFF)
+                return 0; // not included in this subset font
+        }
+        uint8_t pages = (Font->FontHeight + 7) / 8;
+        const uint8_t* data = &Font->paged[glyph * pages * Font->FontWidth];
+        for(i = 0; i < pages; i++) {
+            for(j = 0; j < Font->FontWidth; j++) {
+                column[j] |= (uint32_t)data[i * Font->FontWidth + j] << (8 * i);
+            }
+        }
+    } else {
+        // Transpose the row-major glyph into the column layout of the display RAM
+        for(i = 0; i < Font->FontHeight; i++) {
+            b = Font->data[(ch - 32) * Font->FontHeight + i];
+            for(j = 0; j < Font->FontWidth; j++) {
+                if((b << j) & 0x8000)  {
+                    column[j] |= 1UL << i;
+                }
+            }
+        }
     }
+    return 1;
 }
 
 // Draw 1 char to the screen buffer
@@ -225,13 +754,14 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
 // Font     => Font waarmee we gaan schrijven
 // color    => Black or White
 char ssd1306_WriteChar(char ch, FontDef Font, SSD1306_COLOR color) {
-    uint32_t i, b, j;
+    uint32_t j;
+    uint32_t column[16] = {0};
     
     // Check if character is valid
     if (ch < 32 || ch > 126)
         return 0;
     
-    // Check remaining space on current line
+    // Check remaining space on current line, the glyph is not clipped any further
     if (SSD1306_WIDTH < (SSD1306.CurrentX + Font.FontWidth) ||
         SSD1306_HEIGHT < (SSD1306.CurrentY + Font.FontHeight))
     {
@@ -239,16 +769,14 @@ char ssd1306_WriteChar(char ch, FontDef Font, SSD1306_COLOR color) {
         return 0;
     }
     
-    // Use the font to write
-    for(i = 0; i < Font.FontHeight; i++) {
-        b = Font.data[(ch - 32) * Font.FontHeight + i];
-        for(j = 0; j < Font.FontWidth; j++) {
-            if((b << j) & 0x8000)  {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR) color);
-            } else {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)!color);
-            }
-        }
+    if (!ssd1306_GlyphColumns(ch, &Font, column))
+        return 0;
+    
+    // Use the font to write, background pixels are drawn too
+    ssd1306_WaitDrawable();
+    uint8_t invert = (color == Black) ^ (SSD1306.Inverted != 0);
+    for(j = 0; j < Font.FontWidth; j++) {
+        ssd1306_BlitColumn(SSD1306.CurrentX + j, SSD1306.CurrentY, column[j], Font.FontHeight, invert);
     }
     
     // The current space is now taken
@@ -281,8 +809,75 @@ void ssd1306_SetCursor(uint8_t x, uint8_t y) {
     SSD1306.CurrentY = y;
 }
 
-// Draw line by Bresenhem's algorithm
+/*Fill the box x1..x2, y1..y2 page by page: whole bytes inside, masked bytes at its top and bottom edge.
+ * A horizontal span is one masked byte per column, a vertical span one byte per page.
+ */
+static void ssd1306_FillBlock(int16_t x1, int16_t x2, int16_t y1, int16_t y2, SSD1306_COLOR color) {
+    int16_t swap;
+    ssd1306_WaitDrawable();
+    if(x1 > x2) {
+        swap = x1; x1 = x2; x2 = swap;
+    }
+    if(y1 > y2) {
+        swap = y1; y1 = y2; y2 = swap;
+    }
+    if(x2 < 0 || x1 >= SSD1306_WIDTH || y2 < 0 || y1 >= SSD1306_HEIGHT) {
+        return;
+    }
+    if(x1 < 0) {
+        x1 = 0;
+    }
+    if(x2 >= SSD1306_WIDTH) {
+        x2 = SSD1306_WIDTH - 1;
+    }
+    if(y1 < 0) {
+        y1 = 0;
+    }
+    if(y2 >= SSD1306_HEIGHT) {
+        y2 = SSD1306_HEIGHT - 1;
+    }
+
+    // Check if pixels should be inverted
+    if(SSD1306.Inverted) {
+        color = (SSD1306_COLOR)!color;
+    }
+
+    for(uint8_t page = y1 / 8; page <= y2 / 8; page++) {
+        uint8_t mask = 0xFF;
+        if(page == y1 / 8) {
+            mask &= 0xFF << (y1 % 8);
+        }
+        if(page == y2 / 8) {
+            mask &= 0xFF >> (7 - y2 % 8);
+        }
+
+        uint8_t* byte = &SSD1306_Buffer[page * SSD1306_WIDTH];
+        int16_t first = -1;
+        int16_t last = -1;
+        for(int16_t x = x1; x <= x2; x++) {
+            uint8_t old = byte[x];
+            byte[x] = (color == White) ? (old | mask) : (old & ~mask);
+            if(byte[x] != old) {
+                if(first < 0) {
+                    first = x;
+                }
+                last = x;
+            }
+        }
+        if(first >= 0) {
+            ssd1306_MarkDirty(first, page);
+            ssd1306_MarkDirty(last, page);
+        }
+    }
+}
+
+// Draw line by Bresenhem's algorithm, axis-aligned lines are drawn as spans
 void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
+  if(y1 == y2 || x1 == x2) {
+    ssd1306_FillBlock(x1, x2, y1, y2, color);
+    return;
+  }
+
   int32_t deltaX = abs(x2 - x1);
   int32_t deltaY = abs(y2 - y1);
   int32_t signX = ((x1 < x2) ? 1 : -1);
@@ -331,10 +926,33 @@ void ssd1306_Polyline(const SSD1306_VERTEX *par_vertex, uint16_t par_size, SSD13
   }
   return;
 }
-/*Convert Degrees to Radians*/
-static float ssd1306_DegToRad(float par_deg) {
-    return par_deg * 3.14 / 180.0;
+// sin(0..90 deg) in Q14, the other quadrants are mirrored from it
+static const int16_t SSD1306_SineTable[91] = {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+     2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+     5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+     8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384
+};
+
+/*Sine of an integer angle in degree, Q14*/
+static int16_t ssd1306_Sin(uint16_t par_deg) {
+    par_deg %= 360;
+    if(par_deg <= 90) {
+        return SSD1306_SineTable[par_deg];
+    } else if(par_deg <= 180) {
+        return SSD1306_SineTable[180 - par_deg];
+    } else if(par_deg <= 270) {
+        return -SSD1306_SineTable[par_deg - 180];
+    }
+    return -SSD1306_SineTable[360 - par_deg];
 }
+
 /*Normalize degree to [0;360]*/
 static uint16_t ssd1306_NormalizeTo0_360(uint16_t par_deg) {
   uint16_t loc_angle;
@@ -345,105 +963,313 @@ static uint16_t ssd1306_NormalizeTo0_360(uint16_t par_deg) {
   else
   {
     loc_angle = par_deg % 360;
-    loc_angle = ((par_deg != 0)?par_deg:360);
+    loc_angle = ((loc_angle != 0)?loc_angle:360);
   }
   return loc_angle;
 }
+
+/*Monotonic substitute of the angle of (dx;dy), 0..4095 for 0..360 degree.
+ * Measured like the arcs: 0 points down (+y), 1024 points right (+x).
+ * Only the ordering is exact, which is all an arc needs to clip its ends.
+ */
+static uint16_t ssd1306_PseudoAngle(int32_t dx, int32_t dy) {
+    if(dx >= 0) {
+        if(dy > 0) {
+            return (1024 * dx) / (dx + dy);
+        }
+        if(dx == 0 && dy == 0) {
+            return 0;
+        }
+        return 1024 + (1024 * -dy) / (dx - dy);
+    }
+    if(dy < 0) {
+        return 2048 + (1024 * -dx) / (-dx - dy);
+    }
+    return 3072 + (1024 * dy) / (dy - dx);
+}
+
+// Angular range of an arc in ssd1306_PseudoAngle() units
+typedef struct {
+    uint16_t from;
+    uint16_t to;
+    uint8_t full;
+} SSD1306_ARC_RANGE;
+
+static SSD1306_ARC_RANGE ssd1306_ArcRange(uint16_t start_angle, uint16_t sweep) {
+    SSD1306_ARC_RANGE range;
+    uint16_t loc_start = start_angle % 360;
+    uint16_t loc_end = loc_start + ssd1306_NormalizeTo0_360(sweep);
+
+    range.full = (loc_end - loc_start) >= 360;
+    range.from = ssd1306_PseudoAngle(ssd1306_Sin(loc_start), ssd1306_Sin(loc_start + 90));
+    range.to = ssd1306_PseudoAngle(ssd1306_Sin(loc_end), ssd1306_Sin(loc_end + 90));
+    if(sweep == 0) {
+        range.to = range.from;
+    }
+    return range;
+}
+
+static uint8_t ssd1306_InArc(const SSD1306_ARC_RANGE *range, int32_t dx, int32_t dy) {
+    if(range->full) {
+        return 1;
+    }
+    uint16_t angle = ssd1306_PseudoAngle(dx, dy);
+    if(range->from <= range->to) {
+        return (angle >= range->from) && (angle <= range->to);
+    }
+    // The arc wraps through 0 degree
+    return (angle >= range->from) || (angle <= range->to);
+}
+
+/*Plot the up to 8 symmetric points of one midpoint circle step, clipped to the arc*/
+static void ssd1306_PlotOctants(int16_t cx, int16_t cy, int16_t dx, int16_t dy, const SSD1306_ARC_RANGE *range, SSD1306_COLOR color) {
+    const int16_t offsets[8][2] = {
+        { dx,  dy}, { dy,  dx}, {-dx,  dy}, {-dy,  dx},
+        { dx, -dy}, { dy, -dx}, {-dx, -dy}, {-dy, -dx}
+    };
+    for(uint8_t i = 0; i < 8; i++) {
+        int16_t px = cx + offsets[i][0];
+        int16_t py = cy + offsets[i][1];
+        if(px < 0 || px >= SSD1306_WIDTH || py < 0 || py >= SSD1306_HEIGHT ||
+           !ssd1306_InArc(range, offsets[i][0], offsets[i][1])) {
+            continue;
+        }
+        ssd1306_DrawPixel(px, py, color);
+    }
+}
+
+/*Midpoint circle, every step yields one point per octant*/
+static void ssd1306_MidpointCircle(uint8_t x, uint8_t y, uint8_t radius, const SSD1306_ARC_RANGE *range, SSD1306_COLOR color) {
+    int16_t dx = radius;
+    int16_t dy = 0;
+    int16_t err = 1 - radius;
+
+    while(dx >= dy) {
+        ssd1306_PlotOctants(x, y, dx, dy, range, color);
+        dy++;
+        if(err < 0) {
+            err += 2 * dy + 1;
+        } else {
+            dx--;
+            err += 2 * (dy - dx) + 1;
+        }
+    }
+}
+
+/*Half width of the disc in row dy, the largest dx with dx^2 + dy^2 <= r^2 + r*/
+static int16_t ssd1306_DiscHalfWidth(uint8_t radius, int16_t dy, int16_t previous) {
+    int32_t limit = (int32_t)radius * radius + radius - (int32_t)dy * dy;
+    int16_t dx = previous;
+    // Walking out from the centre row the width only shrinks
+    while(dx > 0 && (int32_t)dx * dx > limit) {
+        dx--;
+    }
+    return dx;
+}
+
 /*DrawArc. Draw angle is beginning from 4 quart of trigonometric circle (3pi/2)
  * start_angle in degree
  * sweep in degree
  */
 void ssd1306_DrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color) {
-    #define CIRCLE_APPROXIMATION_SEGMENTS 36
-    float approx_degree;
-    uint32_t approx_segments;
-    uint8_t xp1,xp2;
-    uint8_t yp1,yp2;
-    uint32_t count = 0;
-    uint32_t loc_sweep = 0;
-    float rad;
-    
-    loc_sweep = ssd1306_NormalizeTo0_360(sweep);
-    
-    count = (ssd1306_NormalizeTo0_360(start_angle) * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
-    approx_segments = (loc_sweep * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
-    approx_degree = loc_sweep / (float)approx_segments;
-    while(count < approx_segments)
-    {
-        rad = ssd1306_DegToRad(count*approx_degree);
-        xp1 = x + (int8_t)(sin(rad)*radius);
-        yp1 = y + (int8_t)(cos(rad)*radius);    
-        count++;
-        if(count != approx_segments)
-        {
-            rad = ssd1306_DegToRad(count*approx_degree);
-        }
-        else
-        {            
-            rad = ssd1306_DegToRad(loc_sweep);
-        }
-        xp2 = x + (int8_t)(sin(rad)*radius);
-        yp2 = y + (int8_t)(cos(rad)*radius);    
-        ssd1306_Line(xp1,yp1,xp2,yp2,color);
+    SSD1306_ARC_RANGE range = ssd1306_ArcRange(start_angle, sweep);
+
+    if(sweep == 0) {
+        return;
     }
-    
+    ssd1306_MidpointCircle(x, y, radius, &range, color);
     return;
 }
-//Draw circle by Bresenhem's algorithm
+
+//Draw circle by the midpoint algorithm
 void ssd1306_DrawCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR par_color) {
-  int32_t x = -par_r;
-  int32_t y = 0;
-  int32_t err = 2 - 2 * par_r;
-  int32_t e2;
+  SSD1306_ARC_RANGE range = { 0, 0, 1 };
 
   if (par_x >= SSD1306_WIDTH || par_y >= SSD1306_HEIGHT) {
     return;
   }
 
-    do {
-      ssd1306_DrawPixel(par_x - x, par_y + y, par_color);
-      ssd1306_DrawPixel(par_x + x, par_y + y, par_color);
-      ssd1306_DrawPixel(par_x + x, par_y - y, par_color);
-      ssd1306_DrawPixel(par_x - x, par_y - y, par_color);
-        e2 = err;
-        if (e2 <= y) {
-            y++;
-            err = err + (y * 2 + 1);
-            if(-x == y && e2 <= x) {
-              e2 = 0;
-            }
-            else
-            {
-              /*nothing to do*/
-            }
-        }
-        else
-        {
-          /*nothing to do*/
-        }
-        if(e2 > x) {
-          x++;
-          err = err + (x * 2 + 1);
-        }
-        else
-        {
-          /*nothing to do*/
+  ssd1306_MidpointCircle(par_x, par_y, par_r, &range, par_color);
+  return;
+}
+
+//Draw a filled circle as horizontal spans
+void ssd1306_FillCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR par_color) {
+  int16_t dy;
+  int16_t dx = par_r;
+
+  if (par_x >= SSD1306_WIDTH || par_y >= SSD1306_HEIGHT) {
+    return;
+  }
+
+  for(dy = 0; dy <= par_r; dy++) {
+    dx = ssd1306_DiscHalfWidth(par_r, dy, dx);
+    ssd1306_FillBlock(par_x - dx, par_x + dx, par_y + dy, par_y + dy, par_color);
+    if(dy != 0) {
+      ssd1306_FillBlock(par_x - dx, par_x + dx, par_y - dy, par_y - dy, par_color);
+    }
+  }
+  return;
+}
+
+/*FillArc. Filled pie slice, angles as in ssd1306_DrawArc()*/
+void ssd1306_FillArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color) {
+    SSD1306_ARC_RANGE range = ssd1306_ArcRange(start_angle, sweep);
+    int16_t dx, dy;
+
+    if(sweep == 0) {
+        return;
+    }
+
+    for(dy = -(int16_t)radius; dy <= radius; dy++) {
+        if(y + dy < 0 || y + dy >= SSD1306_HEIGHT) {
+            continue;
         }
-    } while(x <= 0);
+        int16_t half = ssd1306_DiscHalfWidth(radius, (dy < 0) ? -dy : dy, radius);
+        int16_t first = 0;
+        uint8_t run = 0;
 
+        // A row of a sector is at most two runs, each one is written as a span
+        for(dx = -half; dx <= half + 1; dx++) {
+            uint8_t inside = (dx <= half) && ((dx == 0 && dy == 0) || ssd1306_InArc(&range, dx, dy));
+            if(inside && !run) {
+                first = dx;
+                run = 1;
+            } else if(!inside && run) {
+                ssd1306_FillBlock(x + first, x + dx - 1, y + dy, y + dy, color);
+                run = 0;
+            }
+        }
+    }
     return;
 }
 
+//Draw horizontal line from x1 to x2
+void ssd1306_DrawHLine(uint8_t x1, uint8_t x2, uint8_t y, SSD1306_COLOR color) {
+  ssd1306_FillBlock(x1, x2, y, y, color);
+  return;
+}
+
+//Draw vertical line from y1 to y2
+void ssd1306_DrawVLine(uint8_t x, uint8_t y1, uint8_t y2, SSD1306_COLOR color) {
+  ssd1306_FillBlock(x, x, y1, y2, color);
+  return;
+}
+
 //Draw rectangle
 void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
-  ssd1306_Line(x1,y1,x2,y1,color);
-  ssd1306_Line(x2,y1,x2,y2,color);
-  ssd1306_Line(x2,y2,x1,y2,color);
-  ssd1306_Line(x1,y2,x1,y1,color);
+  ssd1306_DrawHLine(x1,x2,y1,color);
+  ssd1306_DrawHLine(x1,x2,y2,color);
+  ssd1306_DrawVLine(x1,y1,y2,color);
+  ssd1306_DrawVLine(x2,y1,y2,color);
+
+  return;
+}
 
+//Draw filled rectangle, corners included
+void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
+  ssd1306_FillBlock(x1, x2, y1, y2, color);
   return;
 }
 
+// Combines 8 pixels of a column with a screenbuffer byte, only the bits in mask are touched
+static inline void ssd1306_RopByte(uint8_t x, uint8_t page, uint8_t bits, uint8_t mask, SSD1306_ROP rop) {
+    uint8_t* byte = &SSD1306_Buffer[x + page * SSD1306_WIDTH];
+    uint8_t old = *byte;
+    switch(rop) {
+    case SSD1306_ROP_OR:
+        *byte = old | (bits & mask);
+        break;
+    case SSD1306_ROP_AND:
+        *byte = old & (bits | ~mask);
+        break;
+    case SSD1306_ROP_XOR:
+        *byte = old ^ (bits & mask);
+        break;
+    default:
+        *byte = (old & ~mask) | (bits & mask);
+        break;
+    }
+    if(*byte != old) {
+        ssd1306_MarkDirty(x, page);
+    }
+}
+
+// 8 pixels of column col starting at row 8 * page of a row-major bitmap, bit 0 on top
+static uint8_t ssd1306_BitmapRowsColumn(const uint8_t* bitmap, uint8_t w, uint8_t h, uint8_t col, uint8_t page) {
+    uint8_t stride = (w + 7) / 8;
+    const uint8_t* src = &bitmap[page * 8 * stride + col / 8];
+    uint8_t bit = 0x80 >> (col % 8);
+    uint8_t rows = ((h - page * 8) < 8) ? (h - page * 8) : 8;
+    uint8_t bits = 0;
+    for(uint8_t i = 0; i < rows; i++, src += stride) {
+        if(*src & bit) {
+            bits |= 1 << i;
+        }
+    }
+    return bits;
+}
+
+static void ssd1306_Blit(int16_t x, int16_t y, const uint8_t* bitmap, uint8_t w, uint8_t h, uint8_t rows, SSD1306_ROP rop) {
+    ssd1306_WaitDrawable();
+    // Clip once: visible columns of the bitmap and pages that reach the screen
+    int16_t col1 = (x < 0) ? -x : 0;
+    int16_t col2 = ((x + w) > SSD1306_WIDTH) ? (SSD1306_WIDTH - x) : w;
+    int16_t page1 = (y < 0) ? (-y / 8) : 0;
+    int16_t page2 = ((y + h) > SSD1306_HEIGHT) ? ((SSD1306_HEIGHT - y + 7) / 8) : ((h + 7) / 8);
+    if(bitmap == NULL || col1 >= col2 || page1 >= page2) {
+        return;
+    }
+
+    // Drawing in the inverted mode swaps the colours: OR clears, AND sets, copies are negated
+    uint8_t negate = 0x00;
+    if(rop == SSD1306_ROP_INVERT) {
+        negate = 0xFF;
+        rop = SSD1306_ROP_COPY;
+    }
+    if(SSD1306.Inverted && rop != SSD1306_ROP_XOR) {
+        negate ^= 0xFF;
+        if(rop == SSD1306_ROP_OR) {
+            rop = SSD1306_ROP_AND;
+        } else if(rop == SSD1306_ROP_AND) {
+            rop = SSD1306_ROP_OR;
+        }
+    }
+
+    uint8_t shift = y & 7; // also right for negative y, the arithmetic shift below rounds down
+    for(int16_t page = page1; page < page2; page++) {
+        int16_t dst = (y >> 3) + page;
+        uint8_t mask = ((h - page * 8) < 8) ? ((1 << (h - page * 8)) - 1) : 0xFF;
+        const uint8_t* src = &bitmap[page * w];
+
+        if(shift == 0 && !rows) {
+            // Byte aligned: one screen byte per source byte
+            for(int16_t col = col1; col < col2; col++) {
+                ssd1306_RopByte(x + col, dst, src[col] ^ negate, mask, rop);
+            }
+            continue;
+        }
+
+        for(int16_t col = col1; col < col2; col++) {
+            uint8_t bits = (rows ? ssd1306_BitmapRowsColumn(bitmap, w, h, col, page) : src[col]) ^ negate;
+            if(dst >= 0 && dst < SSD1306_HEIGHT / 8) {
+                ssd1306_RopByte(x + col, dst, bits << shift, mask << shift, rop);
+            }
+            if(shift && dst + 1 >= 0 && dst + 1 < SSD1306_HEIGHT / 8) {
+                ssd1306_RopByte(x + col, dst + 1, bits >> (8 - shift), mask >> (8 - shift), rop);
+            }
+        }
+    }
+}
+
+void ssd1306_DrawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, uint8_t w, uint8_t h, SSD1306_ROP rop) {
+    ssd1306_Blit(x, y, bitmap, w, h, 0, rop);
+}
+
+void ssd1306_DrawBitmapRows(int16_t x, int16_t y, const uint8_t* bitmap, uint8_t w, uint8_t h, SSD1306_ROP rop) {
+    ssd1306_Blit(x, y, bitmap, w, h, 1, rop);
+}
+
 void ssd1306_SetContrast(const uint8_t value) {
     const uint8_t kSetContrastControlRegister = 0x81;
     ssd1306_WriteCommand(kSetContrastControlRegister);
@@ -465,3 +1291,166 @@ void ssd1306_SetDisplayOn(const uint8_t on) {
 uint8_t ssd1306_GetDisplayOn() {
     return SSD1306.DisplayOn;
 }
+
+// Scroll setups must not change while a scroll is running, each one stops it first
+void ssd1306_ScrollHorizontal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL interval) {
+    const uint8_t cmds[] = {
+        0x2E,
+        (dir == SSD1306_SCROLL_LEFT) ? 0x27 : 0x26,
+        0x00,       // dummy byte
+        start_page,
+        interval,
+        end_page,
+        0x00,       // dummy bytes
+        0xFF,
+        0x2F
+    };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
+}
+
+void ssd1306_ScrollDiagonal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL interval, uint8_t vertical_offset) {
+    const uint8_t cmds[] = {
+        0x2E,
+        (dir == SSD1306_SCROLL_LEFT) ? 0x2A : 0x29,
+        0x00,       // dummy byte
+        start_page,
+        interval,
+        end_page,
+        vertical_offset & 0x3F, // rows per step
+        0x2F
+    };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
+}
+
+void ssd1306_SetVerticalScrollArea(uint8_t fixed_rows, uint8_t scroll_rows) {
+    const uint8_t cmds[] = { 0xA3, fixed_rows & 0x3F, scroll_rows & 0x7F };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
+}
+
+void ssd1306_StopScroll(void) {
+    ssd1306_WriteCommand(0x2E);
+    // The display RAM content is undefined after a horizontal scroll, send everything next time
+    ssd1306_MarkAllDirty();
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+    SSD1306_FrontValid = 0;
+#endif
+}
+
+void ssd1306_SetStartLine(uint8_t line) {
+    ssd1306_WriteCommand(0x40 | (line & 0x3F));
+}
+
+// Text of the visible console lines, oldest first from Kept, shown again by ssd1306_ConsoleBegin()
+#define SSD1306_CONSOLE_COLUMNS (SSD1306_WIDTH / 4) // fonts are at least 4 pixels wide
+static char SSD1306_ConsoleText[SSD1306_HEIGHT/8][SSD1306_CONSOLE_COLUMNS + 1];
+static uint8_t SSD1306_ConsoleKept;   // ring index of the oldest kept line
+static uint8_t SSD1306_ConsoleCount;  // kept lines, saturates at the visible page count
+
+static uint8_t SSD1306_ConsoleLine[SSD1306_WIDTH];
+
+// Sends one page of the display RAM, outside of the screenbuffer
+static void ssd1306_ConsoleSendPage(uint8_t page) {
+    const uint8_t window[] = { 0x21, 0, SSD1306_WIDTH - 1, 0x22, page, page };
+    ssd1306_WriteCommands(window, sizeof(window));
+    ssd1306_WriteData(SSD1306_ConsoleLine, SSD1306_WIDTH);
+}
+
+// Renders the text up to the end of the line or of the screen, returns the number of chars used
+static size_t ssd1306_ConsoleRender(const char* str) {
+    const FontDef* Font = SSD1306_Console.Font;
+    uint8_t background = SSD1306.Inverted ? 0xFF : 0x00;
+    uint16_t x = 0;
+    size_t n = 0;
+
+    memset(SSD1306_ConsoleLine, background, SSD1306_WIDTH);
+    while(str[n] && str[n] != '\n' && (x + Font->FontWidth) <= SSD1306_WIDTH && n < SSD1306_CONSOLE_COLUMNS) {
+        uint32_t column[16] = {0};
+        ssd1306_GlyphColumns(str[n], Font, column); // unknown chars stay blank
+        for(uint8_t j = 0; j < Font->FontWidth; j++) {
+            SSD1306_ConsoleLine[x + j] = (uint8_t)column[j] ^ background;
+        }
+        x += Font->FontWidth;
+        n++;
+    }
+    return n;
+}
+
+SSD1306_Error_t ssd1306_ConsoleBegin(const FontDef* Font) {
+    if(Font == NULL || Font->FontHeight > 8) {
+        return SSD1306_ERR; // a line has to fit in one page
+    }
+    SSD1306_Console.Font = Font;
+    SSD1306_Console.Page = SSD1306_ConsoleCount;
+    SSD1306_Console.Lines = SSD1306_ConsoleCount;
+    SSD1306_Console.Active = 1;
+
+    // Stop any hardware scroll, show the RAM from page 0 with the kept lines on top, the rest blank
+    const uint8_t cmds[] = { 0x2E, 0x40 };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
+    for(uint8_t page = 0; page < SSD1306_HEIGHT/8; page++) {
+        if(page < SSD1306_ConsoleCount) {
+            ssd1306_ConsoleRender(SSD1306_ConsoleText[(SSD1306_ConsoleKept + page) % (SSD1306_HEIGHT/8)]);
+        } else {
+            ssd1306_ConsoleRender("");
+        }
+        ssd1306_ConsoleSendPage(page);
+    }
+    return SSD1306_OK;
+}
+
+void ssd1306_ConsolePrint(const char* str) {
+    if(!SSD1306_Console.Active) {
+        return;
+    }
+
+    do {
+        uint32_t start = ssd1306_Timestamp();
+        SSD1306_Stats.Bytes = 0;
+        SSD1306_Stats.Transactions = 0;
+
+        // A line is one page transfer, the start line moves it to the bottom of the screen
+        size_t n = ssd1306_ConsoleRender(str);
+        uint8_t slot = (SSD1306_ConsoleKept + SSD1306_ConsoleCount) % (SSD1306_HEIGHT/8);
+        memcpy(SSD1306_ConsoleText[slot], str, n);
+        SSD1306_ConsoleText[slot][n] = '\0';
+        if(SSD1306_ConsoleCount < SSD1306_HEIGHT/8) {
+            SSD1306_ConsoleCount++;
+        } else {
+            SSD1306_ConsoleKept = (SSD1306_ConsoleKept + 1) % (SSD1306_HEIGHT/8); // the oldest line left the screen
+        }
+        str += n;
+        ssd1306_ConsoleSendPage(SSD1306_Console.Page);
+        SSD1306_Console.Page = (SSD1306_Console.Page + 1) % SSD1306_RAM_PAGES;
+        if(SSD1306_Console.Lines < SSD1306_HEIGHT/8) {
+            SSD1306_Console.Lines++;
+        } else {
+            ssd1306_SetStartLine(SSD1306_Console.Page * 8 - SSD1306_HEIGHT);
+        }
+
+        SSD1306_Stats.TimeUs = ssd1306_ElapsedUs(start);
+        if(*str == '\n') {
+            str++;
+        }
+    } while(*str);
+}
+
+void ssd1306_ConsoleEnd(void) {
+    if(!SSD1306_Console.Active) {
+        return;
+    }
+    SSD1306_Console.Active = 0;
+    ssd1306_SetStartLine(0);
+    // The console wrote the display RAM directly, the screenbuffer has to be sent in full
+    ssd1306_MarkAllDirty();
+#if defined(SSD1306_USE_DOUBLE_BUFFER)
+    SSD1306_FrontValid = 0;
+#endif
+}
+
+uint8_t ssd1306_ConsoleIsActive(void) {
+    return SSD1306_Console.Active;
+}
+
+SSD1306_UpdateStats_t ssd1306_GetUpdateStats(void) {
+    return SSD1306_Stats;
+}
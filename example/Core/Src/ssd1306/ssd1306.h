@@ -109,7 +109,8 @@ typedef enum {
 
 typedef enum {
     SSD1306_OK = 0x00,
-    SSD1306_ERR = 0x01  // Generic error.
+    SSD1306_ERR = 0x01, // Generic error.
+    SSD1306_BUSY = 0x02 // Previous asynchronous update not finished yet.
 } SSD1306_Error_t;
 
 // Struct to store transformations
@@ -125,6 +126,47 @@ typedef struct {
     uint8_t y;
 } SSD1306_VERTEX;
 
+// How ssd1306_UpdateScreen() groups the changed pages into bus transactions
+typedef enum {
+    SSD1306_UPDATE_AUTO,  // whichever of the two below puts fewer bytes on the bus
+    SSD1306_UPDATE_PAGES, // changed columns of every page separately
+    SSD1306_UPDATE_FRAME  // full width rows from the first to the last changed page, in one transaction
+} SSD1306_UPDATE_MODE;
+
+// Raster operation of the ssd1306_DrawBitmap() family, set bits of the bitmap are White pixels
+typedef enum {
+    SSD1306_ROP_COPY,  // the bitmap replaces the screen, clear bits are drawn Black
+    SSD1306_ROP_OR,    // set bits are drawn White, the rest is left as it is
+    SSD1306_ROP_AND,   // clear bits are drawn Black, the rest is left as it is
+    SSD1306_ROP_XOR,   // set bits flip the screen, drawing the same bitmap again restores it
+    SSD1306_ROP_INVERT // inverted copy, set bits are drawn Black and clear bits White
+} SSD1306_ROP;
+
+// Direction of the hardware horizontal scroll
+typedef enum {
+    SSD1306_SCROLL_RIGHT,
+    SSD1306_SCROLL_LEFT
+} SSD1306_SCROLL_DIR;
+
+// Frames between two steps of the hardware scroll, values of the command's interval field
+typedef enum {
+    SSD1306_SCROLL_2_FRAMES   = 0x07,
+    SSD1306_SCROLL_3_FRAMES   = 0x04,
+    SSD1306_SCROLL_4_FRAMES   = 0x05,
+    SSD1306_SCROLL_5_FRAMES   = 0x00,
+    SSD1306_SCROLL_25_FRAMES  = 0x06,
+    SSD1306_SCROLL_64_FRAMES  = 0x01,
+    SSD1306_SCROLL_128_FRAMES = 0x02,
+    SSD1306_SCROLL_256_FRAMES = 0x03
+} SSD1306_SCROLL_INTERVAL;
+
+// Bus usage of the last ssd1306_UpdateScreen() call
+typedef struct {
+    uint32_t Bytes;        // bytes on the wire (I2C address and control bytes included)
+    uint16_t Transactions; // I2C start conditions or SPI chip selects
+    uint32_t TimeUs;       // duration of the update in microseconds
+} SSD1306_UpdateStats_t;
+
 // Procedure definitions
 void ssd1306_Init(void);
 void ssd1306_Fill(SSD1306_COLOR color);
@@ -136,8 +178,26 @@ void ssd1306_SetCursor(uint8_t x, uint8_t y);
 void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
 void ssd1306_DrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color);
 void ssd1306_DrawCircle(uint8_t par_x, uint8_t par_y, uint8_t par_r, SSD1306_COLOR color);
+void ssd1306_FillCircle(uint8_t par_x, uint8_t par_y, uint8_t par_r, SSD1306_COLOR par_color);
+void ssd1306_FillArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color);
 void ssd1306_Polyline(const SSD1306_VERTEX *par_vertex, uint16_t par_size, SSD1306_COLOR color);
+void ssd1306_DrawHLine(uint8_t x1, uint8_t x2, uint8_t y, SSD1306_COLOR color);
+void ssd1306_DrawVLine(uint8_t x, uint8_t y1, uint8_t y2, SSD1306_COLOR color);
 void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
+void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
+/**
+ * @brief Draws a page-major 1 bpp bitmap, the layout of the screenbuffer.
+ * @param[in] x, y top left corner, the bitmap is clipped to the screen so it may be negative.
+ * @param[in] bitmap (h + 7) / 8 pages of w bytes, a byte is 8 pixels of a column with bit 0 on top.
+ * @note When y is a multiple of 8 every source byte lands on one screen byte.
+ */
+void ssd1306_DrawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, uint8_t w, uint8_t h, SSD1306_ROP rop);
+/**
+ * @brief Draws a row-major 1 bpp bitmap, e.g. exported by image editors.
+ * @param[in] bitmap h rows of (w + 7) / 8 bytes, a byte is 8 pixels of a row with bit 7 on the left.
+ * @note Slower than ssd1306_DrawBitmap(), the rows are transposed into columns while drawing.
+ */
+void ssd1306_DrawBitmapRows(int16_t x, int16_t y, const uint8_t* bitmap, uint8_t w, uint8_t h, SSD1306_ROP rop);
 /**
  * @brief Sets the contrast of the display.
  * @param[in] value contrast to set.
@@ -156,10 +216,90 @@ void ssd1306_SetDisplayOn(const uint8_t on);
  *          1: ON.
  */
 uint8_t ssd1306_GetDisplayOn();
+/**
+ * @brief Reads bus usage of the last ssd1306_UpdateScreen() call.
+ * @note Only the pages and columns changed since the previous update are sent.
+ */
+SSD1306_UpdateStats_t ssd1306_GetUpdateStats(void);
+/**
+ * @brief Starts sending the changed part of the screenbuffer in the background.
+ * @note Uses DMA when SSD1306_USE_DMA is defined, otherwise it's the same as ssd1306_UpdateScreen().
+ * @note The DMA reads the screenbuffer directly, so without SSD1306_USE_DOUBLE_BUFFER the
+ *       drawing functions wait until the transfer is finished. Poll ssd1306_IsBusy() to avoid that.
+ * @return SSD1306_BUSY if the previous update is still in progress,
+ *         SSD1306_ERR if the transfer could not be started (everything is sent again next time).
+ */
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void);
+/**
+ * @brief Shows the drawn frame and lets the drawing of the next one start immediately.
+ * @note With SSD1306_USE_DOUBLE_BUFFER the drawing buffer is compared with the displayed one,
+ *       only the differing bytes are sent (in the background with SSD1306_USE_DMA). The new
+ *       drawing buffer starts as a copy of the presented frame.
+ * @note Without SSD1306_USE_DOUBLE_BUFFER it's the same as ssd1306_UpdateScreenAsync().
+ * @return SSD1306_BUSY if the previous frame is still being sent, keep drawing and try again,
+ *         SSD1306_ERR if the transfer could not be started.
+ */
+SSD1306_Error_t ssd1306_Present(void);
+void ssd1306_SetUpdateMode(SSD1306_UPDATE_MODE mode);
+/**
+ * @brief Starts a continuous hardware horizontal scroll of pages start_page..end_page (0x26/0x27).
+ * @note The display scrolls on its own, the screenbuffer is not moved. Stop it with ssd1306_StopScroll().
+ */
+void ssd1306_ScrollHorizontal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL interval);
+/**
+ * @brief Starts a continuous vertical and horizontal scroll (0x29/0x2A).
+ * @param[in] vertical_offset rows moved per step, 0 scrolls vertically only when the horizontal pages are empty.
+ * @note The rows that move vertically are set by ssd1306_SetVerticalScrollArea().
+ */
+void ssd1306_ScrollDiagonal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL interval, uint8_t vertical_offset);
+/**
+ * @brief Sets the rows of the vertical scroll (0xA3): fixed_rows on top stay, the scroll_rows below move.
+ */
+void ssd1306_SetVerticalScrollArea(uint8_t fixed_rows, uint8_t scroll_rows);
+/**
+ * @brief Stops the hardware scroll (0x2E).
+ * @note The display RAM has to be rewritten afterwards, the next update sends the whole screenbuffer.
+ */
+void ssd1306_StopScroll(void);
+/**
+ * @brief Sets the display RAM row shown on the top of the screen (0x40 + line), a one-shot vertical scroll.
+ */
+void ssd1306_SetStartLine(uint8_t line);
+/**
+ * @brief Starts a terminal-like text console, new lines scroll the screen up.
+ * @param[in] Font at most 8 pixels high, every text line is one page of the display RAM. Kept until
+ *            ssd1306_ConsoleEnd(), pass one of the global fonts, e.g. &Font_6x8.
+ * @note Shows the last lines of the previous console session again, so the log survives the
+ *       frames drawn in between. A new line costs one page transfer and a start line command,
+ *       ssd1306_GetUpdateStats() reports it.
+ * @note The console writes the display RAM directly, ssd1306_UpdateScreen() does nothing and
+ *       ssd1306_Present() returns SSD1306_BUSY until ssd1306_ConsoleEnd().
+ * @return SSD1306_ERR if the font is too high.
+ */
+SSD1306_Error_t ssd1306_ConsoleBegin(const FontDef* Font);
+/**
+ * @brief Appends text to the console, '\n' and the right edge of the screen start a new line.
+ */
+void ssd1306_ConsolePrint(const char* str);
+/**
+ * @brief Leaves the console, the next update sends the whole screenbuffer again.
+ * @note The text of the visible lines is kept for the next ssd1306_ConsoleBegin().
+ */
+void ssd1306_ConsoleEnd(void);
+uint8_t ssd1306_ConsoleIsActive(void);
+uint8_t ssd1306_IsBusy(void);
+/**
+ * @brief Estimates how long sending the given traffic takes on the bus.
+ * @param[in] bytes, transactions as reported by ssd1306_GetUpdateStats().
+ * @param[in] bus_hz I2C or SPI clock frequency.
+ * @note E.g. a full 128x32 frame at 400kHz I2C is ~12ms, a few changed columns well below 1ms.
+ */
+uint32_t ssd1306_EstimateTransferUs(uint32_t bytes, uint16_t transactions, uint32_t bus_hz);
 
 // Low-level procedures
 void ssd1306_Reset(void);
 void ssd1306_WriteCommand(uint8_t byte);
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t len);
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size);
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len);
 
@@ -20,6 +20,14 @@
 #define SSD1306_USE_I2C
 //#define SSD1306_USE_SPI
 
+// Send the screenbuffer by DMA in ssd1306_UpdateScreenAsync()
+// (needs the I2C TX / SPI TX DMA stream and interrupts set up in CubeMX)
+#define SSD1306_USE_DMA
+
+// Draw into a second buffer while the first one is being sent by ssd1306_Present()
+// (costs another SSD1306_BUFFER_SIZE bytes of RAM)
+#define SSD1306_USE_DOUBLE_BUFFER
+
 // I2C Configuration
 #define SSD1306_I2C_PORT        hi2c1
 #define SSD1306_I2C_ADDR        (0x3C << 1)
@@ -46,6 +54,10 @@
 #define SSD1306_INCLUDE_FONT_11x18
 //#define SSD1306_INCLUDE_FONT_16x26
 
+// Use the page-major font tables generated by fontgen.py (ssd1306_fonts_paged.c),
+// smaller and faster to draw than the row-major ones
+#define SSD1306_USE_PAGED_FONTS
+
 // Some OLEDs don't display anything in first two columns.
 // In this case change the following macro to 130.
 // The default value is 128.
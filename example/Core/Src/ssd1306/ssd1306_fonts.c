@@ -1,7 +1,8 @@
+#include <stddef.h>
 
 #include "ssd1306_fonts.h"
 
-#ifdef SSD1306_INCLUDE_FONT_7x10
+#if defined(SSD1306_INCLUDE_FONT_7x10) && !defined(SSD1306_USE_PAGED_FONTS)
 static const uint16_t Font7x10 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // sp
 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x0000, 0x1000, 0x0000, 0x0000,  // !
@@ -101,7 +102,7 @@ static const uint16_t Font7x10 [] = {
 };
 #endif
 
-#ifdef SSD1306_INCLUDE_FONT_11x18
+#if defined(SSD1306_INCLUDE_FONT_11x18) // also kept with paged fonts for Font_11x18_rows
 static const uint16_t Font11x18 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,   // sp
 0x0000, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0000, 0x0C00, 0x0C00, 0x0000, 0x0000, 0x0000,   // !
@@ -200,7 +201,7 @@ static const uint16_t Font11x18 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3880, 0x7F80, 0x4700, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,   // ~
 };
 #endif
-#ifdef SSD1306_INCLUDE_FONT_16x26
+#if defined(SSD1306_INCLUDE_FONT_16x26) && !defined(SSD1306_USE_PAGED_FONTS)
 static const uint16_t Font16x26 [] = {
 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [ ]
 0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03C0,0x03C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x0000,0x0000,0x0000,0x03E0,0x03E0,0x03E0,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [!]
@@ -299,7 +300,7 @@ static const uint16_t Font16x26 [] = {
 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x3F07,0x7FC7,0x73E7,0xF1FF,0xF07E,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [~]
 };
 #endif
-#ifdef SSD1306_INCLUDE_FONT_6x8
+#if defined(SSD1306_INCLUDE_FONT_6x8) && !defined(SSD1306_USE_PAGED_FONTS)
 static const uint16_t Font6x8 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // sp
 0x2000, 0x2000, 0x2000, 0x2000, 0x2000, 0x0000, 0x2000, 0x0000,  // !
@@ -399,6 +400,8 @@ static const uint16_t Font6x8 [] = {
 };
 #endif
 
+// With SSD1306_USE_PAGED_FONTS the fonts come from ssd1306_fonts_paged.c (see fontgen.py)
+#ifndef SSD1306_USE_PAGED_FONTS
 #ifdef SSD1306_INCLUDE_FONT_6x8
 FontDef Font_6x8 = {6,8,Font6x8};
 #endif
@@ -411,3 +414,9 @@ FontDef Font_11x18 = {11,18,Font11x18};
 #ifdef SSD1306_INCLUDE_FONT_16x26
 FontDef Font_16x26 = {16,26,Font16x26};
 #endif
+#endif
+
+// Row-major reference for ssd1306_TestTextSpeed(), removed by --gc-sections when the test isn't linked
+#ifdef SSD1306_INCLUDE_FONT_11x18
+FontDef Font_11x18_rows = {11,18,Font11x18,NULL,NULL};
+#endif
@@ -8,7 +8,9 @@
 typedef struct {
 	const uint8_t FontWidth;    /*!< Font width in pixels */
 	uint8_t FontHeight;   /*!< Font height in pixels */
-	const uint16_t *data; /*!< Pointer to data font data array */
+	const uint16_t *data; /*!< Pointer to data font data array (row-major), NULL for paged fonts */
+	const uint8_t *paged; /*!< Page-major column bytes generated by fontgen.py, NULL if not available */
+	const uint8_t *glyphMap; /*!< ch - 32 -> index in paged for subset fonts, NULL when all 95 glyphs are present */
 } FontDef;
 
 #ifdef SSD1306_INCLUDE_FONT_6x8
@@ -19,6 +21,7 @@ extern FontDef Font_7x10;
 #endif
 #ifdef SSD1306_INCLUDE_FONT_11x18
 extern FontDef Font_11x18;
+extern FontDef Font_11x18_rows; // always row-major, for comparing with the paged tables
 #endif
 #ifdef SSD1306_INCLUDE_FONT_16x26
 extern FontDef Font_16x26;
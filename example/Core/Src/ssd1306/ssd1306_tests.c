@@ -68,6 +68,7 @@ void ssd1306_TestFPS() {
     uint32_t start = HAL_GetTick();
     uint32_t end = start;
     int fps = 0;
+    uint32_t bytes = 0;
     char message[] = "ABCDEFGHIJK";
    
     ssd1306_SetCursor(2,0);
@@ -77,6 +78,7 @@ void ssd1306_TestFPS() {
         ssd1306_SetCursor(2, 18);
         ssd1306_WriteString(message, Font_11x18, Black);
         ssd1306_UpdateScreen();
+        bytes += ssd1306_GetUpdateStats().Bytes;
        
         char ch = message[0];
         memmove(message, message+1, sizeof(message)-2);
@@ -89,13 +91,132 @@ void ssd1306_TestFPS() {
     HAL_Delay(1000);
 
     char buff[64];
+    bytes /= fps;
     fps = (float)fps / ((end - start) / 1000.0);
     snprintf(buff, sizeof(buff), "~%d FPS", fps);
    
     ssd1306_Fill(White);
     ssd1306_SetCursor(2, 2);
     ssd1306_WriteString(buff, Font_11x18, Black);
+	#ifdef SSD1306_INCLUDE_FONT_7x10
+    snprintf(buff, sizeof(buff), "%lu bytes/frame", (unsigned long)bytes);
+    ssd1306_SetCursor(2, 20);
+    ssd1306_WriteString(buff, Font_7x10, Black);
+	#endif
+    ssd1306_UpdateScreen();
+}
+
+// Sends the same full screen changes page by page and as one window
+void ssd1306_TestUpdateModes() {
+    const SSD1306_UPDATE_MODE modes[] = {SSD1306_UPDATE_PAGES, SSD1306_UPDATE_FRAME};
+    SSD1306_UpdateStats_t stats[2];
+
+    for(uint8_t m = 0; m < 2; m++) {
+        ssd1306_SetUpdateMode(modes[m]);
+        ssd1306_Fill(White);
+        ssd1306_UpdateScreen();
+        ssd1306_Fill(Black);
+        ssd1306_UpdateScreen();
+        stats[m] = ssd1306_GetUpdateStats();
+    }
+    ssd1306_SetUpdateMode(SSD1306_UPDATE_AUTO);
+
+    char buff[32];
+	#ifdef SSD1306_INCLUDE_FONT_7x10
+    for(uint8_t m = 0; m < 2; m++) {
+        snprintf(buff, sizeof(buff), "%s %u tr %luus", m ? "frame" : "pages",
+                 stats[m].Transactions, (unsigned long)stats[m].TimeUs);
+        ssd1306_SetCursor(2, 2 + 12 * m);
+        ssd1306_WriteString(buff, Font_7x10, White);
+    }
+	#endif
+    ssd1306_UpdateScreen();
+}
+
+// Reference per-pixel glyph renderer, the way ssd1306_WriteChar used to work
+static void ssd1306_TestWriteCharPixels(uint8_t x, uint8_t y, char ch, FontDef Font, SSD1306_COLOR color) {
+    if(Font.data == NULL) {
+        return; // paged font, no row-major table to compare with
+    }
+    for(uint32_t i = 0; i < Font.FontHeight; i++) {
+        uint32_t b = Font.data[(ch - 32) * Font.FontHeight + i];
+        for(uint32_t j = 0; j < Font.FontWidth; j++) {
+            ssd1306_DrawPixel(x + j, y + i, ((b << j) & 0x8000) ? color : (SSD1306_COLOR)!color);
+        }
+    }
+}
+
+// Text rendering throughput: per-pixel renderer, column blitter fed from the row-major table
+// and from Font_11x18 (the page-major table with SSD1306_USE_PAGED_FONTS)
+void ssd1306_TestTextSpeed() {
+    const char message[] = "Hello world";
+    const char* name[3] = { "pixel", "rows ", Font_11x18.paged ? "paged" : "rows " };
+    const uint32_t rounds = 1000;
+    uint32_t time[3];
+
+    for(uint8_t m = 0; m < 3; m++) {
+        uint32_t start = HAL_GetTick();
+        for(uint32_t r = 0; r < rounds; r++) {
+            uint8_t y = r % (SSD1306_HEIGHT - Font_11x18.FontHeight); // also unaligned to pages
+            if(m == 0) {
+                for(uint8_t c = 0; message[c]; c++) {
+                    ssd1306_TestWriteCharPixels(c * Font_11x18.FontWidth, y, message[c], Font_11x18_rows, White);
+                }
+            } else {
+                ssd1306_SetCursor(0, y);
+                ssd1306_WriteString((char*)message, (m == 1) ? Font_11x18_rows : Font_11x18, White);
+            }
+        }
+        time[m] = HAL_GetTick() - start;
+    }
+
+    char buff[32];
+    ssd1306_Fill(Black);
+	#ifdef SSD1306_INCLUDE_FONT_7x10
+    for(uint8_t m = 0; m < 3; m++) {
+        snprintf(buff, sizeof(buff), "%s %lu str/s", name[m],
+                 (unsigned long)(rounds * 1000 / (time[m] ? time[m] : 1)));
+        ssd1306_SetCursor(2, 11 * m);
+        ssd1306_WriteString(buff, Font_7x10, White);
+    }
+	#endif
+    ssd1306_UpdateScreen();
+}
+
+// Cycles per call of the drawing primitives, the DWT counter is started by ssd1306_Init()
+void ssd1306_TestPrimitives() {
+#ifdef DWT
+    const char* names[] = { "pixel", "line", "hline", "vline", "rect", "fill" };
+    const uint32_t rounds = 64;
+    uint32_t cycles[6];
+
+    for(uint8_t op = 0; op < 6; op++) {
+        uint32_t start = DWT->CYCCNT;
+        for(uint32_t r = 0; r < rounds; r++) {
+            SSD1306_COLOR color = (r & 1) ? Black : White; // every call changes the buffer
+            switch(op) {
+            case 0: ssd1306_DrawPixel(r % SSD1306_WIDTH, r % SSD1306_HEIGHT, color); break;
+            case 1: ssd1306_Line(0, r % SSD1306_HEIGHT, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1 - r % SSD1306_HEIGHT, color); break;
+            case 2: ssd1306_DrawHLine(0, SSD1306_WIDTH - 1, r % SSD1306_HEIGHT, color); break;
+            case 3: ssd1306_DrawVLine(r % SSD1306_WIDTH, 0, SSD1306_HEIGHT - 1, color); break;
+            case 4: ssd1306_FillRectangle(10, 3, SSD1306_WIDTH - 10, SSD1306_HEIGHT - 3, color); break;
+            default: ssd1306_Fill(color); break;
+            }
+        }
+        cycles[op] = (DWT->CYCCNT - start) / rounds;
+    }
+
+    char buff[32];
+    ssd1306_Fill(Black);
+	#ifdef SSD1306_INCLUDE_FONT_6x8
+    for(uint8_t op = 0; op < 6; op++) {
+        snprintf(buff, sizeof(buff), "%s %lu", names[op], (unsigned long)cycles[op]);
+        ssd1306_SetCursor((op % 2) * 64, (op / 2) * 10);
+        ssd1306_WriteString(buff, Font_6x8, White);
+    }
+	#endif
     ssd1306_UpdateScreen();
+#endif
 }
 
 void ssd1306_TestLine() {
@@ -132,6 +253,15 @@ void ssd1306_TestArc() {
   return;
 }
 
+void ssd1306_TestFilled() {
+  ssd1306_FillCircle(20, 15, 12, White);
+  ssd1306_FillArc(60, 15, 14, 45, 270, White);
+  ssd1306_FillCircle(100, 15, 14, White);
+  ssd1306_FillArc(100, 15, 10, 0, 90, Black);
+  ssd1306_UpdateScreen();
+  return;
+}
+
 void ssd1306_TestPolyline() {
   SSD1306_VERTEX loc_vertex[] =
   {
@@ -153,6 +283,12 @@ void ssd1306_TestAll() {
     ssd1306_Init();
     ssd1306_TestFPS();
     HAL_Delay(3000);
+    ssd1306_TestUpdateModes();
+    HAL_Delay(3000);
+    ssd1306_TestTextSpeed();
+    HAL_Delay(3000);
+    ssd1306_TestPrimitives();
+    HAL_Delay(3000);
     ssd1306_TestBorder();
     ssd1306_TestFonts();
     HAL_Delay(3000);
@@ -169,5 +305,8 @@ void ssd1306_TestAll() {
     ssd1306_Fill(Black);
     ssd1306_TestCircle();
     HAL_Delay(3000);
+    ssd1306_Fill(Black);
+    ssd1306_TestFilled();
+    HAL_Delay(3000);
 }
 
@@ -8,11 +8,15 @@ _BEGIN_STD_C
 void ssd1306_TestBorder(void);
 void ssd1306_TestFonts(void);
 void ssd1306_TestFPS(void);
+void ssd1306_TestUpdateModes(void);
+void ssd1306_TestTextSpeed(void);
+void ssd1306_TestPrimitives(void);
 void ssd1306_TestAll(void);
 void ssd1306_TestLine(void);
 void ssd1306_TestRectangle(void);
 void ssd1306_TestCircle(void);
 void ssd1306_TestArc(void);
+void ssd1306_TestFilled(void);
 void ssd1306_TestPolyline(void);
 
 
@@ -0,0 +1,209 @@
+//  Replay of synthetic Synaptics® traces through the advanced gesture mode decoder
+//
+// The fake device streams scripted packets: one finger, two fingers with
+// primary (W = 0) and secondary (W = 2) packets interleaved, three
+// fingers and lift. Every frame has to come back with the right contacts,
+// and no secondary packet may show up as the primary position.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include "fake_ps2.h"
+#include "touchpad.h"
+
+#define MAX_PACKETS 400
+
+#define CHECK(cond)                                                  \
+    do                                                               \
+    {                                                                \
+        if (!(cond))                                                 \
+        {                                                            \
+            printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+            failures++;                                              \
+        }                                                            \
+    } while (0)
+
+typedef struct // what the device reports in one packet
+{
+    uint16_t x, y;
+    uint8_t z, w;
+    bool secondary;
+} Packet;
+
+static Packet script[MAX_PACKETS];
+static uint16_t scriptLength, scriptNext;
+static bool playing; // the script starts once the driver is set up, idle packets before
+static int failures;
+
+static uint8_t source(uint32_t sample_us, uint8_t *p)
+{
+    (void)sample_us;
+    if (!playing) // idle during the setup, relative or absolute
+    {
+        if (fake_getModeByte() & 0x80)
+        {
+            fake_encodeAbsolute(0, 0, 0, 4, 0, p);
+            return 6;
+        }
+        p[0] = 0x08;
+        p[1] = p[2] = 0;
+        return 3;
+    }
+    if (scriptNext >= scriptLength)
+        return 0;
+    const Packet *s = &script[scriptNext++];
+    if (s->secondary)
+        fake_encodeSecondary(s->x, s->y, s->z, p);
+    else
+        fake_encodeAbsolute(s->x, s->y, s->z, s->w, 0, p);
+    return 6;
+}
+
+static void add(uint16_t x, uint16_t y, uint8_t z, uint8_t w, bool secondary)
+{
+    Packet p = {x, y, z, w, secondary};
+    script[scriptLength++] = p;
+}
+
+// finger 1 moves right, finger 2 moves left and down
+static uint16_t fingerX1(uint16_t i) { return 1500 + 10 * i; }
+static uint16_t fingerY1(uint16_t i) { return 2000 + 5 * i; }
+static uint16_t fingerX2(uint16_t i) { return 5000 - 8 * i; }
+static uint16_t fingerY2(uint16_t i) { return 4000 - 6 * i; }
+
+static void setUp(bool agm_capable)
+{
+    fake_reset(source);
+    if (!agm_capable)
+        fake_setCapabilities(SYN_CAP_EXTENDED | (4UL << 20), 0);
+    scriptLength = scriptNext = 0;
+    playing = false;
+}
+
+static int8_t readFrame(touchpad_ContactFrame *frame)
+{
+    for (uint8_t i = 0; i < 100; i++) // up to one second for the next packet
+    {
+        int8_t err = touchpad_readContacts(frame);
+        if ((err == TOUCHPAD_OK) && (frame->w == 4) && (frame->contact[0].x == 0))
+            continue; // idle packet sent before the script started
+        if (err != TOUCHPAD_NO_DATA_TO_READ)
+            return err;
+        fake_advance(10000);
+    }
+    return TOUCHPAD_NO_DATA_TO_READ;
+}
+
+static void testEnable()
+{
+    setUp(true);
+    CHECK(touchapd_init() == TOUCHPAD_OK);
+    CHECK(touchpad_enableMultiFinger() == TOUCHPAD_OK);
+    CHECK(fake_isAdvancedGesture());
+    CHECK((fake_getModeByte() & 0x85) == 0x85); // absolute, EW and W mode
+    CHECK(touchpad_getCurrentMode() == eAbsoluteMode);
+
+    setUp(false);
+    CHECK(touchapd_init() == TOUCHPAD_OK);
+    CHECK(touchpad_enableMultiFinger() == TOUCHPAD_NOT_SUPPORTED);
+    CHECK(!fake_isAdvancedGesture());
+}
+
+static void testTwoFingerTrace()
+{
+    touchpad_ContactFrame frame;
+    setUp(true);
+    for (uint16_t i = 0; i < 20; i++) // one finger
+        add(fingerX1(i), fingerY1(i), 60, 4, false);
+    for (uint16_t i = 20; i < 120; i++) // second finger lands, packets alternate
+    {
+        add(fingerX1(i), fingerY1(i), 60, 0, false);
+        add(fingerX2(i), fingerY2(i), 50, 2, true);
+    }
+    for (uint16_t i = 120; i < 140; i++) // second finger lifted
+        add(fingerX1(i), fingerY1(i), 60, 4, false);
+    for (uint16_t i = 140; i < 150; i++) // three fingers
+        add(fingerX1(i), fingerY1(i), 70, 1, false);
+    add(0, 0, 0, 0, false); // lift
+
+    CHECK(touchapd_init() == TOUCHPAD_OK);
+    CHECK(touchpad_enableMultiFinger() == TOUCHPAD_OK);
+    playing = true;
+
+    for (uint16_t i = 0; i < 150; i++)
+    {
+        CHECK(readFrame(&frame) == TOUCHPAD_OK);
+        // the primary position follows finger 1 only, no jumps to finger 2
+        CHECK((frame.contact[0].x == fingerX1(i)) && (frame.contact[0].y == fingerY1(i)));
+        CHECK(frame.contact[0].valid);
+        if (i < 20)
+        {
+            CHECK(frame.fingers == 1);
+            CHECK(!frame.contact[1].valid);
+        }
+        else if (i < 120)
+        {
+            CHECK(frame.fingers == 2);
+            CHECK(frame.w == 0);
+            // the secondary packet comes after the primary one, so the frame holds the previous one
+            if (i > 20)
+            {
+                CHECK(frame.contact[1].valid);
+                CHECK((frame.contact[1].x == (fingerX2(i - 1) & ~1)) && (frame.contact[1].y == (fingerY2(i - 1) & ~1)));
+                CHECK(frame.contact[1].z == 50);
+            }
+        }
+        else if (i < 140)
+        {
+            CHECK(frame.fingers == 1);
+            CHECK(!frame.contact[1].valid);
+        }
+        else
+        {
+            CHECK(frame.fingers == 3);
+        }
+    }
+    CHECK(readFrame(&frame) == TOUCHPAD_OK);
+    CHECK((frame.fingers == 0) && !frame.contact[0].valid);
+    CHECK(fake_getDroppedBytes() == 0);
+}
+
+// the single finger reader on the same stream must never see the secondary finger
+static void testAbsolutePositionSkipsSecondary()
+{
+    setUp(true);
+    for (uint16_t i = 0; i < 50; i++)
+    {
+        add(fingerX1(i), fingerY1(i), 60, 0, false);
+        add(fingerX2(i), fingerY2(i), 50, 2, true);
+    }
+    CHECK(touchapd_init() == TOUCHPAD_OK);
+    CHECK(touchpad_enableMultiFinger() == TOUCHPAD_OK);
+    playing = true;
+
+    uint16_t x, y;
+    uint8_t z;
+    uint16_t i = 0;
+    for (uint16_t t = 0; (t < 1000) && (i < 50); t++)
+    {
+        fake_advance(5000);
+        while (touchapd_readAbsolutePosition(&x, &y, &z) == TOUCHPAD_OK)
+        {
+            if ((x == 0) && (z == 0))
+                continue; // idle packet sent before the script started
+            CHECK((x == fingerX1(i)) && (y == fingerY1(i)) && (z == 60));
+            i++;
+        }
+    }
+    CHECK(i == 50);
+}
+
+int main()
+{
+    testEnable();
+    testTwoFingerTrace();
+    testAbsolutePositionSkipsSecondary();
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
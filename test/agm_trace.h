@@ -0,0 +1,58 @@
+//  Captured absolute mode trace
+//
+// What touchapd_readAbsolutePosition() and touchpad_getPacketTimestamp()
+// returned while the two finger trace of agm_replay.c was played through
+// fake_ps2.c: one finger, 100 packets with a second finger whose secondary
+// packets halve the primary packet rate, a press with three fingers.
+// Points are x, y, z, timestamp [ms].
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __AGM_TRACE_H__
+#define __AGM_TRACE_H__
+
+#include "stroke.h"
+
+static const stroke_Point agm_trace[] = {
+    {1500, 2000, 60, 138}, {1510, 2005, 60, 163}, {1520, 2010, 60, 188}, {1530, 2015, 60, 213},
+    {1540, 2020, 60, 238}, {1550, 2025, 60, 263}, {1560, 2030, 60, 288}, {1570, 2035, 60, 313},
+    {1580, 2040, 60, 338}, {1590, 2045, 60, 363}, {1600, 2050, 60, 388}, {1610, 2055, 60, 413},
+    {1620, 2060, 60, 438}, {1630, 2065, 60, 463}, {1640, 2070, 60, 488}, {1650, 2075, 60, 513},
+    {1660, 2080, 60, 538}, {1670, 2085, 60, 563}, {1680, 2090, 60, 588}, {1690, 2095, 60, 613},
+    {1700, 2100, 60, 638}, {1710, 2105, 60, 688}, {1720, 2110, 60, 738}, {1730, 2115, 60, 788},
+    {1740, 2120, 60, 838}, {1750, 2125, 60, 888}, {1760, 2130, 60, 938}, {1770, 2135, 60, 988},
+    {1780, 2140, 60, 1038}, {1790, 2145, 60, 1088}, {1800, 2150, 60, 1138}, {1810, 2155, 60, 1188},
+    {1820, 2160, 60, 1238}, {1830, 2165, 60, 1288}, {1840, 2170, 60, 1338}, {1850, 2175, 60, 1388},
+    {1860, 2180, 60, 1438}, {1870, 2185, 60, 1488}, {1880, 2190, 60, 1538}, {1890, 2195, 60, 1588},
+    {1900, 2200, 60, 1638}, {1910, 2205, 60, 1688}, {1920, 2210, 60, 1738}, {1930, 2215, 60, 1788},
+    {1940, 2220, 60, 1838}, {1950, 2225, 60, 1888}, {1960, 2230, 60, 1938}, {1970, 2235, 60, 1988},
+    {1980, 2240, 60, 2038}, {1990, 2245, 60, 2088}, {2000, 2250, 60, 2138}, {2010, 2255, 60, 2188},
+    {2020, 2260, 60, 2238}, {2030, 2265, 60, 2288}, {2040, 2270, 60, 2338}, {2050, 2275, 60, 2388},
+    {2060, 2280, 60, 2438}, {2070, 2285, 60, 2489}, {2080, 2290, 60, 2539}, {2090, 2295, 60, 2588},
+    {2100, 2300, 60, 2638}, {2110, 2305, 60, 2688}, {2120, 2310, 60, 2738}, {2130, 2315, 60, 2788},
+    {2140, 2320, 60, 2838}, {2150, 2325, 60, 2888}, {2160, 2330, 60, 2938}, {2170, 2335, 60, 2988},
+    {2180, 2340, 60, 3038}, {2190, 2345, 60, 3088}, {2200, 2350, 60, 3138}, {2210, 2355, 60, 3188},
+    {2220, 2360, 60, 3238}, {2230, 2365, 60, 3288}, {2240, 2370, 60, 3338}, {2250, 2375, 60, 3388},
+    {2260, 2380, 60, 3438}, {2270, 2385, 60, 3488}, {2280, 2390, 60, 3538}, {2290, 2395, 60, 3588},
+    {2300, 2400, 60, 3638}, {2310, 2405, 60, 3688}, {2320, 2410, 60, 3738}, {2330, 2415, 60, 3788},
+    {2340, 2420, 60, 3838}, {2350, 2425, 60, 3888}, {2360, 2430, 60, 3938}, {2370, 2435, 60, 3988},
+    {2380, 2440, 60, 4038}, {2390, 2445, 60, 4088}, {2400, 2450, 60, 4138}, {2410, 2455, 60, 4188},
+    {2420, 2460, 60, 4238}, {2430, 2465, 60, 4288}, {2440, 2470, 60, 4338}, {2450, 2475, 60, 4388},
+    {2460, 2480, 60, 4438}, {2470, 2485, 60, 4488}, {2480, 2490, 60, 4538}, {2490, 2495, 60, 4588},
+    {2500, 2500, 60, 4638}, {2510, 2505, 60, 4688}, {2520, 2510, 60, 4738}, {2530, 2515, 60, 4788},
+    {2540, 2520, 60, 4838}, {2550, 2525, 60, 4888}, {2560, 2530, 60, 4938}, {2570, 2535, 60, 4989},
+    {2580, 2540, 60, 5039}, {2590, 2545, 60, 5088}, {2600, 2550, 60, 5138}, {2610, 2555, 60, 5188},
+    {2620, 2560, 60, 5238}, {2630, 2565, 60, 5288}, {2640, 2570, 60, 5338}, {2650, 2575, 60, 5388},
+    {2660, 2580, 60, 5438}, {2670, 2585, 60, 5488}, {2680, 2590, 60, 5538}, {2690, 2595, 60, 5588},
+    {2700, 2600, 60, 5638}, {2710, 2605, 60, 5663}, {2720, 2610, 60, 5688}, {2730, 2615, 60, 5713},
+    {2740, 2620, 60, 5738}, {2750, 2625, 60, 5763}, {2760, 2630, 60, 5788}, {2770, 2635, 60, 5813},
+    {2780, 2640, 60, 5838}, {2790, 2645, 60, 5863}, {2800, 2650, 60, 5888}, {2810, 2655, 60, 5913},
+    {2820, 2660, 60, 5938}, {2830, 2665, 60, 5963}, {2840, 2670, 60, 5988}, {2850, 2675, 60, 6013},
+    {2860, 2680, 60, 6038}, {2870, 2685, 60, 6063}, {2880, 2690, 60, 6088}, {2890, 2695, 60, 6113},
+    {2900, 2700, 70, 6138}, {2910, 2705, 70, 6163}, {2920, 2710, 70, 6188}, {2930, 2715, 70, 6213},
+    {2940, 2720, 70, 6238}, {2950, 2725, 70, 6263}, {2960, 2730, 70, 6288}, {2970, 2735, 70, 6313},
+    {2980, 2740, 70, 6338}, {2990, 2745, 70, 6363},
+};
+
+#endif
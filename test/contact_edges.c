@@ -0,0 +1,161 @@
+//  Edges of the touch contact state machine
+//
+// Steps the default configuration through the hover and touch hysteresis,
+// the dwell times, a pressure dip while lifting and a lift finished by
+// contact_poll() after the device went silent, checking the time stamp and
+// position of every edge. A random pressure stream then has to give
+// properly nested edges.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "contact.h"
+
+#define RANDOM_SAMPLES 100000
+
+#define CHECK(cond)                                                  \
+    do                                                               \
+    {                                                                \
+        if (!(cond))                                                 \
+        {                                                            \
+            printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+            failures++;                                              \
+        }                                                            \
+    } while (0)
+
+static contact_Tracker tracker;
+static contact_Event event;
+static int failures;
+
+static contact_EventType update(uint8_t z, uint32_t t)
+{
+    return contact_update(&tracker, 1000 + t, 2000 - t, z, t, &event); // the position tells the sample apart
+}
+
+static void testHover()
+{
+    contact_init(&tracker, NULL);
+    CHECK(update(CONTACT_DEFAULT_HOVER_ON_Z - 1, 0) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_HOVER_ON_Z, 10) == eContactHoverEnter);
+    CHECK((event.timestamp == 10) && (event.x == 1010) && (event.y == 1990));
+    CHECK(update(CONTACT_DEFAULT_HOVER_OFF_Z, 20) == eContactNoEvent); // between the thresholds
+    CHECK(contact_getState(&tracker) == eContactHover);
+    CHECK(update(CONTACT_DEFAULT_HOVER_OFF_Z - 1, 30) == eContactHoverLeave);
+    CHECK(event.timestamp == 30);
+    CHECK(update(CONTACT_DEFAULT_HOVER_OFF_Z, 40) == eContactNoEvent);
+    CHECK(contact_getState(&tracker) == eContactNone);
+}
+
+static void testTouch()
+{
+    contact_init(&tracker, NULL);
+    CHECK(update(CONTACT_DEFAULT_HOVER_ON_Z, 0) == eContactHoverEnter);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z - 1, 10) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 20) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 20 + CONTACT_DEFAULT_TOUCH_DWELL - 1) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 20 + CONTACT_DEFAULT_TOUCH_DWELL) == eContactTouchDown);
+    CHECK((event.timestamp == 20) && (event.z == CONTACT_DEFAULT_TOUCH_ON_Z)); // when the pressure rose
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z, 50) == eContactNoEvent); // between the thresholds
+    CHECK(contact_getState(&tracker) == eContactTouching);
+
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 1, 60) == eContactNoEvent);
+    CHECK(contact_getState(&tracker) == eContactLifting);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 1, 60 + CONTACT_DEFAULT_LIFT_DWELL) == eContactTouchUp);
+    CHECK((event.timestamp == 60) && (event.x == 1000 + 60 + CONTACT_DEFAULT_LIFT_DWELL));
+    CHECK(contact_getState(&tracker) == eContactHover);
+
+    // too short press
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 100) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z - 1, 100 + CONTACT_DEFAULT_TOUCH_DWELL - 1) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 100 + CONTACT_DEFAULT_TOUCH_DWELL) == eContactNoEvent); // dwell restarts
+    CHECK(contact_getState(&tracker) == eContactHover);
+}
+
+static void testDipWhileLifting()
+{
+    contact_init(&tracker, NULL);
+    update(CONTACT_DEFAULT_TOUCH_ON_Z, 0);
+    update(CONTACT_DEFAULT_TOUCH_ON_Z, CONTACT_DEFAULT_TOUCH_DWELL);
+    CHECK(contact_getState(&tracker) == eContactTouching);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 10, 100) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z, 100 + CONTACT_DEFAULT_LIFT_DWELL - 1) == eContactNoEvent); // came back
+    CHECK(contact_getState(&tracker) == eContactTouching);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 1, 200) == eContactNoEvent); // lift dwell starts again
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 1, 200 + CONTACT_DEFAULT_LIFT_DWELL - 1) == eContactNoEvent);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_OFF_Z - 1, 200 + CONTACT_DEFAULT_LIFT_DWELL) == eContactTouchUp);
+    CHECK(event.timestamp == 200);
+}
+
+// a finger pressed and lifted at once still gives hover enter and leave around the touch
+static void testPollFinishesLift()
+{
+    contact_init(&tracker, NULL);
+    CHECK(update(CONTACT_DEFAULT_TOUCH_ON_Z, 0) == eContactHoverEnter);
+    CHECK(contact_poll(&tracker, CONTACT_DEFAULT_TOUCH_DWELL, &event) == eContactTouchDown);
+    CHECK((event.timestamp == 0) && (event.x == 1000));
+    CHECK(update(40, 20) == eContactNoEvent);
+    CHECK(update(0, 30) == eContactNoEvent); // last packet, no position without a finger
+    CHECK(contact_poll(&tracker, 30 + CONTACT_DEFAULT_LIFT_DWELL - 1, &event) == eContactNoEvent);
+    CHECK(contact_poll(&tracker, 30 + CONTACT_DEFAULT_LIFT_DWELL, &event) == eContactTouchUp);
+    CHECK((event.timestamp == 30) && (event.x == 1020) && (event.y == 1980) && (event.z == 0));
+    CHECK(contact_poll(&tracker, 60, &event) == eContactHoverLeave);
+    CHECK((event.timestamp == 60) && (event.x == 1020));
+    CHECK(contact_poll(&tracker, 70, &event) == eContactNoEvent);
+    CHECK(contact_getState(&tracker) == eContactNone);
+}
+
+// random pressure with packets 12-13 ms apart and gaps where only contact_poll() runs
+static void testNesting()
+{
+    bool hovering = false, touching = false;
+    uint32_t t = 0, unbalanced = 0, future = 0;
+    contact_init(&tracker, NULL);
+    srand(1);
+    for (uint32_t i = 0; i < RANDOM_SAMPLES; i++)
+    {
+        contact_EventType e;
+        t += 12 + (i & 1);
+        if (rand() % 8 == 0)
+            e = contact_poll(&tracker, t, &event);
+        else
+            e = update((uint8_t)(rand() % 4 ? rand() % 50 : 0), t);
+        if ((e != eContactNoEvent) && (event.timestamp > t))
+            future++;
+        switch (e)
+        {
+        case eContactHoverEnter:
+            unbalanced += hovering;
+            hovering = true;
+            break;
+        case eContactHoverLeave:
+            unbalanced += !hovering || touching;
+            hovering = false;
+            break;
+        case eContactTouchDown:
+            unbalanced += !hovering || touching;
+            touching = true;
+            break;
+        case eContactTouchUp:
+            unbalanced += !touching;
+            touching = false;
+            break;
+        default:
+            break;
+        }
+    }
+    CHECK(unbalanced == 0);
+    CHECK(future == 0);
+}
+
+int main()
+{
+    testHover();
+    testTouch();
+    testDipWhileLifting();
+    testPollFinishesLift();
+    testNesting();
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,362 @@
+//  Host stand-in for the PS/2 layer: a simulated clock and Synaptics® touchpad
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <string.h>
+#include "fake_ps2.h"
+#include "touchpad.h"
+
+#define WIRE_SIZE 64
+#define MODE_ABSOLUTE 0x80
+#define MODE_HIGH_RATE 0x40
+
+typedef struct // byte sent by the device, reaches the FIFO at the given time
+{
+    uint8_t byte;
+    uint32_t at;
+} fake_WireByte;
+
+static uint32_t fake_Now;
+static fake_PacketSource fake_Source;
+static uint32_t fake_Caps, fake_ExtCaps;
+
+static fake_WireByte fake_Wire[WIRE_SIZE];
+static uint8_t fake_WireIn, fake_WireOut;
+static uint8_t fake_Fifo[RX_FIFO_SIZE]; // same size and overflow behaviour as ps2.c
+static uint8_t fake_FifoIn, fake_FifoOut;
+static uint32_t fake_Dropped;
+static uint32_t fake_Resets; // 0xFF commands received
+
+// device state
+static bool fake_Enabled, fake_Remote, fake_Agm;
+static uint8_t fake_Rate, fake_ModeByte;
+static uint8_t fake_Resolution, fake_Scaling21; // relative mode settings, the status request reports them
+static uint8_t fake_SavedResolution;             // before a sliced argument, Synaptics® commands leave it alone
+static uint8_t fake_ArgFor;      // command waiting for its argument byte, 0 = none
+static uint32_t fake_Sliced;     // Synaptics® argument built from 0xE8 parameters
+static uint8_t fake_SliceCount;
+static uint32_t fake_NextSample; // [us] stream mode
+
+// [us] between two stream mode packets
+static uint32_t fake_period()
+{
+    if (fake_ModeByte & MODE_ABSOLUTE)
+        return (fake_ModeByte & MODE_HIGH_RATE) ? 12500 : 25000; // 80 or 40 packets/s
+    return 1000000 / (fake_Rate ? fake_Rate : 100);
+}
+
+static void fake_send(const uint8_t *bytes, uint8_t count, uint32_t from)
+{
+    uint8_t last = (fake_WireIn + WIRE_SIZE - 1) % WIRE_SIZE;
+    uint32_t at = from;
+    if ((fake_WireIn != fake_WireOut) && (fake_Wire[last].at > at))
+        at = fake_Wire[last].at; // the previous packet is still being sent
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t next = (fake_WireIn + 1) % WIRE_SIZE;
+        if (next == fake_WireOut)
+            return; // host doesn't read at all, the device stops sending
+        at += FAKE_BYTE_US;
+        fake_Wire[fake_WireIn].byte = bytes[i];
+        fake_Wire[fake_WireIn].at = at;
+        fake_WireIn = next;
+    }
+}
+
+// moves everything that has arrived by now into the FIFO
+static void fake_deliver()
+{
+    while (fake_Enabled && !fake_Remote && (fake_NextSample <= fake_Now))
+    {
+        uint8_t packet[8];
+        uint8_t n = fake_Source ? fake_Source(fake_NextSample, packet) : 0;
+        fake_send(packet, n, fake_NextSample);
+        fake_NextSample += fake_period();
+    }
+    while ((fake_WireIn != fake_WireOut) && (fake_Wire[fake_WireOut].at <= fake_Now))
+    {
+        if (fake_FifoIn == ((fake_FifoOut + RX_FIFO_SIZE - 1) % RX_FIFO_SIZE))
+        {
+            fake_Dropped++; // buffer is full, drop data
+        }
+        else
+        {
+            fake_Fifo[fake_FifoIn] = fake_Wire[fake_WireOut].byte;
+            fake_FifoIn = (fake_FifoIn + 1) % RX_FIFO_SIZE;
+        }
+        fake_WireOut = (fake_WireOut + 1) % WIRE_SIZE;
+    }
+}
+
+static void fake_query(uint8_t query, uint8_t *r)
+{
+    uint32_t v = 0;
+    if (query == 0x00) // Identify TouchPad: minor 1, model code, major 8
+    {
+        r[0] = 0x01;
+        r[1] = 0x47;
+        r[2] = 0x18;
+        return;
+    }
+    if (query == 0x02)
+        v = fake_Caps;
+    else if (query == 0x0C)
+        v = fake_ExtCaps;
+    r[0] = (uint8_t)(v >> 16);
+    r[1] = (uint8_t)(v >> 8);
+    r[2] = (uint8_t)v;
+}
+
+// the device's answer to one received byte, starting with the ACK
+static uint8_t fake_command(uint8_t b, uint8_t *r)
+{
+    uint8_t n = 0;
+    r[n++] = 0xFA;
+    if (fake_ArgFor)
+    {
+        uint8_t cmd = fake_ArgFor;
+        fake_ArgFor = 0;
+        if (cmd == 0xE8)
+        {
+            if (fake_SliceCount == 0)
+                fake_SavedResolution = fake_Resolution;
+            fake_Resolution = b & 0x03;
+            fake_Sliced = (fake_Sliced << 2) | (b & 0x03);
+            fake_SliceCount++;
+            return n;
+        }
+        // 0xF3: after four sliced parameters the rate is a Synaptics® special command
+        if (fake_SliceCount >= 4)
+            fake_Resolution = fake_SavedResolution;
+        if ((fake_SliceCount >= 4) && (b == 0x14))
+            fake_ModeByte = (uint8_t)fake_Sliced;
+        else if ((fake_SliceCount >= 4) && (b == 0xC8) && ((uint8_t)fake_Sliced == 0x03))
+            fake_Agm = true;
+        else if (fake_SliceCount < 4)
+            fake_Rate = b;
+        fake_SliceCount = 0;
+        return n;
+    }
+
+    if ((b == 0xE8) && (fake_SliceCount >= 4))
+        fake_SliceCount = 0; // a fifth 0xE8 starts a new argument
+    if ((b != 0xE8) && (b != 0xF3) && (b != 0xE9))
+        fake_SliceCount = 0; // only 0xF3 and 0xE9 consume the sliced argument
+    if (fake_SliceCount == 0)
+        fake_Sliced = 0;
+
+    switch (b)
+    {
+    case 0xFF: // Reset
+        fake_Enabled = fake_Remote = fake_Agm = false;
+        fake_Rate = 100;
+        fake_Resolution = 2;
+        fake_Scaling21 = 0;
+        fake_ModeByte = 0;
+        r[n++] = 0xAA;
+        r[n++] = 0x00;
+        fake_Resets++;
+        break;
+    case 0xF6: // Set Defaults, also back to stream mode
+        fake_Enabled = fake_Remote = false;
+        fake_Rate = 100;
+        fake_Resolution = 2;
+        fake_Scaling21 = 0;
+        break;
+    case 0xE6:
+        fake_Scaling21 = 0;
+        break;
+    case 0xE7:
+        fake_Scaling21 = 1;
+        break;
+    case 0xF5:
+        fake_Enabled = false;
+        break;
+    case 0xF4:
+        fake_Enabled = true;
+        fake_NextSample = fake_Now + fake_period();
+        break;
+    case 0xF0:
+        fake_Remote = true;
+        break;
+    case 0xEA:
+        fake_Remote = false;
+        fake_NextSample = fake_Now + fake_period();
+        break;
+    case 0xF2: // Get Device ID, no IntelliMouse extensions
+        r[n++] = 0x00;
+        break;
+    case 0xE8:
+    case 0xF3:
+        fake_ArgFor = b;
+        break;
+    case 0xE9:
+        if (fake_SliceCount >= 4)
+        {
+            fake_query((uint8_t)fake_Sliced, &r[n]);
+            fake_Resolution = fake_SavedResolution;
+        }
+        else
+        {
+            r[n] = (fake_Remote ? 0x40 : 0x00) | (fake_Enabled ? 0x20 : 0x00) | (fake_Scaling21 ? 0x10 : 0x00);
+            r[n + 1] = fake_Resolution;
+            r[n + 2] = fake_Rate;
+        }
+        n += 3;
+        fake_SliceCount = 0;
+        break;
+    case 0xEB: // Read Data, the packet follows the ACK
+        if (fake_Source)
+            n += fake_Source(fake_Now, &r[n]);
+        break;
+    default:
+        break;
+    }
+    return n;
+}
+
+void fake_reset(fake_PacketSource source)
+{
+    fake_Now = 0;
+    fake_Source = source;
+    fake_WireIn = fake_WireOut = 0;
+    fake_FifoIn = fake_FifoOut = 0;
+    fake_Dropped = 0;
+    fake_Resets = 0;
+    fake_Resolution = 2;
+    fake_Scaling21 = 0;
+    fake_Enabled = fake_Remote = fake_Agm = false;
+    fake_Rate = 100;
+    fake_ModeByte = 0;
+    fake_ArgFor = 0;
+    fake_Sliced = 0;
+    fake_SliceCount = 0;
+    fake_Caps = SYN_CAP_EXTENDED | (4UL << 20) | SYN_CAP_MULTIFINGER;
+    fake_ExtCaps = SYN_EXTCAP_ADV_GESTURE;
+}
+
+void fake_setCapabilities(uint32_t capabilities, uint32_t ext_capabilities)
+{
+    fake_Caps = capabilities;
+    fake_ExtCaps = ext_capabilities;
+}
+
+void fake_advance(uint32_t us)
+{
+    fake_Now += us;
+    fake_deliver();
+}
+
+uint32_t fake_now()
+{
+    return fake_Now;
+}
+
+uint8_t fake_getModeByte()
+{
+    return fake_ModeByte;
+}
+
+bool fake_isAdvancedGesture()
+{
+    return fake_Agm;
+}
+
+bool fake_isRemote()
+{
+    return fake_Remote;
+}
+
+uint32_t fake_getResets()
+{
+    return fake_Resets;
+}
+
+uint32_t fake_getDroppedBytes()
+{
+    return fake_Dropped;
+}
+
+void fake_encodeAbsolute(uint16_t x, uint16_t y, uint8_t z, uint8_t w, uint8_t buttons, uint8_t *p)
+{
+    p[0] = 0x80 | ((w & 0x0C) << 2) | ((w & 0x02) << 1) | (buttons & 0x03);
+    p[1] = (uint8_t)((((y >> 8) & 0x0F) << 4) | ((x >> 8) & 0x0F));
+    p[2] = z;
+    p[3] = 0xC0 | (((y >> 12) & 0x01) << 5) | (((x >> 12) & 0x01) << 4) | ((w & 0x01) << 2) | (buttons & 0x03);
+    p[4] = (uint8_t)x;
+    p[5] = (uint8_t)y;
+}
+
+void fake_encodeSecondary(uint16_t x, uint16_t y, uint8_t z, uint8_t *p)
+{
+    uint16_t hx = x >> 1, hy = y >> 1;
+    uint8_t hz = z >> 1;
+    p[0] = 0x80 | 0x04; // W = 2
+    p[1] = (uint8_t)hx;
+    p[2] = (uint8_t)hy;
+    p[3] = 0xC0 | (hz & 0x30);
+    p[4] = (uint8_t)((((hy >> 8) & 0x0F) << 4) | ((hx >> 8) & 0x0F));
+    p[5] = 0x10 | (hz & 0x0F); // packet type 1 for image sensors
+}
+
+// ps2.h API
+
+uint32_t HAL_GetTick()
+{
+    fake_advance(FAKE_TICK_US);
+    return fake_Now / 1000;
+}
+
+void HAL_Delay(uint32_t ms)
+{
+    fake_advance(ms * 1000);
+}
+
+bool ps2_readByte(uint8_t *byte)
+{
+    fake_deliver();
+    if (fake_FifoIn == fake_FifoOut)
+        return false;
+    *byte = fake_Fifo[fake_FifoOut];
+    fake_FifoOut = (fake_FifoOut + 1) % RX_FIFO_SIZE;
+    return true;
+}
+
+bool ps2_isDataAvaiable(uint8_t n_bytes)
+{
+    fake_deliver();
+    return (((fake_FifoIn + RX_FIFO_SIZE - fake_FifoOut) % RX_FIFO_SIZE) >= n_bytes);
+}
+
+void ps2_scheduleRx()
+{
+}
+
+// the host inhibits the bus: the packet being sent is lost, then the byte goes out
+// and the device answers before it continues streaming
+void ps2_sendByte(uint8_t byte)
+{
+    uint8_t r[12];
+    fake_WireIn = fake_WireOut = 0;
+    fake_Now += FAKE_BYTE_US;
+    uint8_t n = fake_command(byte, r);
+    fake_send(r, n, fake_Now);
+    uint32_t answered = fake_Now + n * FAKE_BYTE_US;
+    if (fake_NextSample < answered)
+        fake_NextSample = answered;
+}
+
+void ps2_startRx()
+{
+    fake_FifoIn = fake_FifoOut = 0;
+}
+
+bool ps2_getACK()
+{
+    uint8_t v = 0;
+    ps2_startRx();
+    for (uint32_t t = 0; (t < 30) && !ps2_readByte(&v); t++)
+        fake_advance(1000);
+    return (v == 0xFA);
+}
@@ -0,0 +1,37 @@
+//  Host stand-in for the PS/2 layer: a simulated clock and Synaptics® touchpad
+//
+// Implements the ps2.h API on top of a device model, so touchpad.c runs
+// unmodified on the host. Every byte on the wire takes FAKE_BYTE_US, the
+// receive FIFO drops data when full like the real one. Packets come from
+// a caller supplied source, sampled at the device rate in stream mode or
+// at the 0xEB request in remote mode.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __FAKE_PS2_H__
+#define __FAKE_PS2_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ps2.h"
+
+#define FAKE_BYTE_US 1000 // one 11 bit frame at ~11 kHz PS/2 clock
+#define FAKE_TICK_US 10   // CPU time charged per HAL_GetTick() call, busy-wait loops make progress
+
+typedef uint8_t (*fake_PacketSource)(uint32_t sample_us, uint8_t *packet); // returns the packet length, 0 = nothing to send
+
+void fake_reset(fake_PacketSource source); // power-on state, clock at 0
+void fake_setCapabilities(uint32_t capabilities, uint32_t ext_capabilities);
+void fake_advance(uint32_t us);            // lets the device run, like time spent by the application
+uint32_t fake_now();                       // [us]
+uint8_t fake_getModeByte();
+bool fake_isAdvancedGesture();             // advanced gesture mode turned on by the host
+bool fake_isRemote();                      // remote reporting, packets only on 0xEB
+uint32_t fake_getResets();                 // 0xFF commands received since fake_reset()
+uint32_t fake_getDroppedBytes();           // lost because the FIFO was full
+
+void fake_encodeAbsolute(uint16_t x, uint16_t y, uint8_t z, uint8_t w, uint8_t buttons, uint8_t *p);
+void fake_encodeSecondary(uint16_t x, uint16_t y, uint8_t z, uint8_t *p); // AGM packet, half resolution
+
+#endif
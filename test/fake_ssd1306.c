@@ -0,0 +1,128 @@
+//  Host stand-in for the SSD1306 on the I2C bus: a real time clock and the display RAM
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <time.h>
+#include "fake_ssd1306.h"
+
+I2C_HandleTypeDef hi2c1;
+
+static uint8_t fake_Ram[FAKE_PAGES][FAKE_COLUMNS];
+static uint8_t fake_ColStart, fake_ColEnd = FAKE_COLUMNS - 1, fake_PageStart, fake_PageEnd = FAKE_PAGES - 1;
+static uint8_t fake_Col, fake_Page;
+static uint8_t fake_Cmd[8];    // command waiting for its arguments
+static uint8_t fake_CmdLength; // bytes of it received so far
+static uint8_t fake_CmdNeeds;  // its total length
+static uint32_t fake_Bytes;
+
+// length of a command including its arguments
+static uint8_t fake_commandLength(uint8_t cmd)
+{
+    switch (cmd)
+    {
+    case 0x21: // column window
+    case 0x22: // page window
+    case 0xA3: // vertical scroll area
+        return 3;
+    case 0x26: // horizontal scroll
+    case 0x27:
+        return 7;
+    case 0x29: // diagonal scroll
+    case 0x2A:
+        return 6;
+    case 0x20: // addressing mode
+    case 0x81: // contrast
+    case 0x8D: // charge pump
+    case 0xA8: // multiplex ratio
+    case 0xD3: // display offset
+    case 0xD5: // clock
+    case 0xD9: // pre-charge
+    case 0xDA: // COM pins
+    case 0xDB: // VCOMH
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+static void fake_command(uint8_t b)
+{
+    if (fake_CmdLength == 0)
+        fake_CmdNeeds = fake_commandLength(b);
+    fake_Cmd[fake_CmdLength++] = b;
+    if (fake_CmdLength < fake_CmdNeeds)
+        return;
+    fake_CmdLength = 0;
+    if (fake_Cmd[0] == 0x21)
+    {
+        fake_ColStart = fake_Cmd[1] % FAKE_COLUMNS;
+        fake_ColEnd = fake_Cmd[2] % FAKE_COLUMNS;
+        fake_Col = fake_ColStart;
+    }
+    else if (fake_Cmd[0] == 0x22)
+    {
+        fake_PageStart = fake_Cmd[1] % FAKE_PAGES;
+        fake_PageEnd = fake_Cmd[2] % FAKE_PAGES;
+        fake_Page = fake_PageStart;
+    }
+}
+
+static void fake_data(uint8_t b)
+{
+    fake_Ram[fake_Page][fake_Col] = b;
+    if (++fake_Col > fake_ColEnd)
+    {
+        fake_Col = fake_ColStart;
+        if (++fake_Page > fake_PageEnd)
+            fake_Page = fake_PageStart;
+    }
+}
+
+uint8_t fake_getDisplayByte(uint8_t page, uint8_t column)
+{
+    return fake_Ram[page % FAKE_PAGES][column % FAKE_COLUMNS];
+}
+
+uint32_t fake_getBusBytes()
+{
+    return fake_Bytes;
+}
+
+// HAL
+
+uint32_t HAL_GetTick()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void HAL_Delay(uint32_t ms)
+{
+    (void)ms; // the display needs no time to start
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size, uint32_t timeout)
+{
+    (void)hi2c;
+    (void)addr;
+    (void)mem_size;
+    (void)timeout;
+    fake_Bytes += size;
+    for (uint16_t i = 0; i < size; i++)
+    {
+        if (mem == 0x40)
+            fake_data(data[i]);
+        else
+            fake_command(data[i]);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size)
+{
+    HAL_I2C_Mem_Write(hi2c, addr, mem, mem_size, data, size, HAL_MAX_DELAY);
+    HAL_I2C_MemTxCpltCallback(hi2c);
+    return HAL_OK;
+}
@@ -0,0 +1,25 @@
+//  Host stand-in for the SSD1306 on the I2C bus: a real time clock and the display RAM
+//
+// Implements the HAL calls of ssd1306.c, so the driver runs unmodified on
+// the host. Commands are parsed far enough to follow the column and page
+// windows (0x21, 0x22), data bytes land in the display RAM like in the
+// horizontal addressing mode. DMA transfers complete immediately.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __FAKE_SSD1306_H__
+#define __FAKE_SSD1306_H__
+
+#include <stdint.h>
+#include "stm32f7xx_hal.h"
+
+#define FAKE_PAGES 8
+#define FAKE_COLUMNS 128
+
+extern I2C_HandleTypeDef hi2c1;
+
+uint8_t fake_getDisplayByte(uint8_t page, uint8_t column); // 8 pixels of a column, bit 0 on top
+uint32_t fake_getBusBytes();                               // data and command bytes sent so far
+
+#endif
@@ -0,0 +1,134 @@
+//  Mode switching in remote reporting mode
+//
+// touchpad_setMode() must not reset the device or its relative mode
+// settings, and the driver has to keep polling a device that still is in
+// remote mode. Every packet carries a counter, so a report read from an
+// ACK byte or a lost packet shows up as a gap.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include "fake_ps2.h"
+#include "touchpad.h"
+
+#define POLL_US 10000
+#define POLLS 50
+
+#define CHECK(cond)                                                  \
+    do                                                               \
+    {                                                                \
+        if (!(cond))                                                 \
+        {                                                            \
+            printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+            failures++;                                              \
+        }                                                            \
+    } while (0)
+
+static const touchpad_Config config = {eResolution8cpmm, eScaling2to1, eSampleRate100fps}; // as in the example
+static uint8_t counter;
+static int failures;
+
+static uint8_t source(uint32_t sample_us, uint8_t *p)
+{
+    (void)sample_us;
+    counter = (counter + 1) & 0x7F;
+    if (fake_getModeByte() & 0x80)
+    {
+        fake_encodeAbsolute(1000 + counter, 2000, 60, 4, 0, p);
+        return 6;
+    }
+    p[0] = 0x08;
+    p[1] = counter; // dx
+    p[2] = 1;       // dy
+    return 3;
+}
+
+static void checkSettings()
+{
+    touchpad_Status status;
+    CHECK(touchpad_readStatus(&status) == TOUCHPAD_OK);
+    CHECK(status.remoteMode && fake_isRemote());
+    CHECK(touchpad_getReportingMode() == eRemoteReporting);
+    CHECK((status.resolution == config.resolution) && (status.scaling == config.scaling) &&
+          (status.sampleRate == config.sampleRate));
+}
+
+// polls like the TIM6 interrupt, every poll has to give the next packet
+static void pollAndRead(touchapd_Mode mode)
+{
+    int16_t last = -1;
+    uint16_t reports = 0;
+    for (uint16_t i = 0; i < POLLS; i++)
+    {
+        touchpad_remotePoll();
+        for (uint16_t t = 0; t < POLL_US; t += 500)
+        {
+            touchpad_processCommands();
+            fake_advance(500);
+            int16_t value = -1;
+            int8_t err;
+            if (mode == eMovementMode)
+            {
+                touchpad_MouseReport report;
+                err = touchpad_readMouseReport(&report);
+                if (err == TOUCHPAD_OK)
+                {
+                    CHECK(report.dy == 1);
+                    value = report.dx;
+                }
+            }
+            else
+            {
+                uint16_t x, y;
+                uint8_t z;
+                err = touchapd_readAbsolutePosition(&x, &y, &z);
+                if (err == TOUCHPAD_OK)
+                {
+                    CHECK((y == 2000) && (z == 60));
+                    value = x - 1000;
+                }
+            }
+            CHECK((err == TOUCHPAD_OK) || (err == TOUCHPAD_NO_DATA_TO_READ));
+            if (value < 0)
+                continue;
+            CHECK((last < 0) || (value == ((last + 1) & 0x7F)));
+            last = value;
+            reports++;
+        }
+    }
+    CHECK(reports >= POLLS - 1);
+}
+
+int main()
+{
+    fake_reset(source);
+    CHECK(touchapd_init() == TOUCHPAD_OK);
+    CHECK(touchpad_beginConfig(&config) == TOUCHPAD_OK);
+    int8_t err;
+    while ((err = touchpad_processCommands()) == TOUCHPAD_BUSY)
+        fake_advance(500);
+    CHECK(err == TOUCHPAD_OK);
+    CHECK(touchpad_setReportingMode(eRemoteReporting) == TOUCHPAD_OK);
+    checkSettings();
+    pollAndRead(eMovementMode);
+
+    CHECK(touchpad_setMode(eMovementMode) == TOUCHPAD_OK); // movement to movement
+    checkSettings();
+    pollAndRead(eMovementMode);
+
+    CHECK(touchpad_setMode(eAbsoluteMode) == TOUCHPAD_OK);
+    CHECK(touchpad_getCurrentMode() == eAbsoluteMode);
+    checkSettings();
+    pollAndRead(eAbsoluteMode);
+
+    CHECK(touchpad_setMode(eMovementMode) == TOUCHPAD_OK);
+    CHECK(touchpad_getCurrentMode() == eMovementMode);
+    checkSettings();
+    pollAndRead(eMovementMode);
+
+    CHECK(fake_getResets() == 1); // only touchapd_init()
+    CHECK(fake_getDroppedBytes() == 0);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
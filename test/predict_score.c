@@ -0,0 +1,153 @@
+//  Prediction error of predict.c on synthetic finger traces
+//
+// Each trace is sampled at 80 packets/s with millisecond time stamps and
+// integer positions, like touchpad_getPacketTimestamp() and the absolute
+// mode packets. Frames are drawn every FRAME_MS like the main loop of the
+// example does, in each one the position is predicted LATENCY ms ahead and
+// compared with the true position at that time; the baseline is drawing
+// the last packet as it is. Errors are in touchpad units, the pad
+// is about 4000 x 3000 of them.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "predict.h"
+
+#define PERIOD_US 12500 // 80 packets/s
+#define DURATION_MS 3000
+#define FRAME_MS 4 // main loop period, a few frames between two packets
+#define MAX_SAMPLES (DURATION_MS / FRAME_MS)
+#define JITTER 6 // [units] sensor noise of the jitter trace
+#define PI 3.14159265358979
+
+typedef struct
+{
+    const char *name;
+    void (*position)(double t_ms, double *x, double *y);
+    bool smooth; // prediction has to beat the baseline here, elsewhere it must not be much worse
+} Trace;
+
+typedef struct
+{
+    double mean, p95;
+} Score;
+
+static void line(double t, double *x, double *y) // swipe at 1000 units/s
+{
+    *x = 1500 + 1.0 * t;
+    *y = 2000 + 0.4 * t;
+}
+
+static void circle(double t, double *x, double *y) // 800 units radius, 1.5 s per turn
+{
+    *x = 3500 + 800 * cos(2 * PI * t / 1500);
+    *y = 3000 + 800 * sin(2 * PI * t / 1500);
+}
+
+static void fling(double t, double *x, double *y) // starts from rest and speeds up
+{
+    double s = t / 1000;
+    *x = 1500 + 400 * s * s;
+    *y = 2500 + 150 * s * s;
+}
+
+static void reversal(double t, double *x, double *y) // scrubbing back and forth, 0.8 s period
+{
+    *x = 3500 + 1000 * sin(2 * PI * t / 800);
+    *y = 3000;
+}
+
+static void jitter(double t, double *x, double *y) // slow drag with sensor noise, noise added when sampling
+{
+    *x = 2000 + 0.2 * t;
+    *y = 3000 + 0.1 * t;
+}
+
+static const Trace traces[] = {
+    {"line", line, true},
+    {"circle", circle, true},
+    {"fling", fling, true},
+    {"reversal", reversal, false},
+    {"jitter", jitter, false},
+};
+
+static int compare(const void *a, const void *b)
+{
+    double d = *(const double *)a - *(const double *)b;
+    return (d > 0) - (d < 0);
+}
+
+static Score score(double *err, uint16_t n)
+{
+    Score s = {0, 0};
+    for (uint16_t i = 0; i < n; i++)
+        s.mean += err[i];
+    s.mean /= n;
+    qsort(err, n, sizeof(err[0]), compare);
+    s.p95 = err[n * 95 / 100];
+    return s;
+}
+
+static void run(const Trace *trace, uint16_t latency_ms, Score *predicted, Score *baseline)
+{
+    static double errP[MAX_SAMPLES], errB[MAX_SAMPLES];
+    predict_State state;
+    uint16_t n = 0;
+    srand(1);
+    predict_init(&state, 50, 100); // same setup as the example application
+
+    uint32_t k = 0; // packets added
+    double x = 0, y = 0;
+    for (uint32_t now = 0; now < DURATION_MS; now += FRAME_MS)
+    {
+        for (double t; (t = k * PERIOD_US / 1000.0) <= now; k++)
+        {
+            trace->position(t, &x, &y);
+            if (trace->position == jitter)
+            {
+                x += rand() % (2 * JITTER + 1) - JITTER;
+                y += rand() % (2 * JITTER + 1) - JITTER;
+            }
+            predict_addSample(&state, (uint16_t)lround(x), (uint16_t)lround(y), (uint32_t)t);
+        }
+        if (k <= PREDICT_HISTORY)
+            continue; // the first packets of a touch are not scored
+
+        uint16_t px, py;
+        double tx, ty;
+        predict_getPosition(&state, now + latency_ms, &px, &py);
+        trace->position(now + latency_ms, &tx, &ty);
+        errP[n] = hypot(px - tx, py - ty);
+        errB[n] = hypot(lround(x) - tx, lround(y) - ty);
+        n++;
+    }
+    *predicted = score(errP, n);
+    *baseline = score(errB, n);
+}
+
+int main()
+{
+    static const uint16_t latencies[] = {15, 30, 50};
+    bool ok = true;
+
+    printf("position error [units] LATENCY ms after each %u ms frame, 80 packets/s\n", FRAME_MS);
+    printf("trace     latency  predicted mean/p95   last packet mean/p95\n");
+    for (uint8_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++)
+    {
+        for (uint8_t j = 0; j < sizeof(latencies) / sizeof(latencies[0]); j++)
+        {
+            Score p, b;
+            run(&traces[i], latencies[j], &p, &b);
+            printf("%-9s %4u ms  %8.1f %8.1f    %8.1f %8.1f\n", traces[i].name, latencies[j], p.mean, p.p95, b.mean, b.p95);
+            if (traces[i].smooth && (p.mean >= b.mean))
+                ok = false;
+            if (!traces[i].smooth && (p.p95 > 1.25 * b.p95))
+                ok = false;
+        }
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+//  Recogniser accuracy and time per match on synthetic strokes
+//
+// Every default shape is drawn SAMPLES times with a random rotation of
+// +-15 degrees, scale of 0.4 to 1.4 and +-20 units of noise per point,
+// a point every ~40 units like a finger at 80 packets/s. The strokes go
+// through the stroke recorder, so the compressed path is what gets
+// matched. Times are for the host CPU, they only compare the steps.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "recognize.h"
+
+#define SAMPLES 100
+#define NOISE 20
+#define STEP 40 // [units] between two packets
+#define MAX_TEMPLATES 32 // matching budget per display frame
+#define REPEAT 100000
+#define PI 3.14159265358979
+
+typedef struct
+{
+    const char *name; // drawn shape, matches the template name
+    const double *corners; // x0, y0, x1, y1, ... of a polyline, NULL for the arcs
+    uint8_t count;
+} Shape;
+
+static const double check[] = {-400, 200, -150, -300, 600, 700};
+static const double right[] = {-1000, 0, 1000, 0};
+static const double left[] = {1000, 0, -1000, 0};
+static const double up[] = {0, -1000, 0, 1000};
+static const double down[] = {0, 1000, 0, -1000};
+static const double caret[] = {-600, -800, 0, 800, 600, -800};
+static const double vee[] = {-600, 800, 0, -800, 600, 800};
+static const double zed[] = {-700, 700, 700, 700, -700, -700, 700, -700};
+static const double ell[] = {-500, 900, -500, -900, 500, -900};
+static const double triangle[] = {0, 900, -800, -700, 800, -700, 0, 900};
+static const double rectangle[] = {-800, 800, -800, -800, 800, -800, 800, 800, -800, 800};
+static const double arrow[] = {-800, 0, 800, 0, 400, 400, 800, 0, 400, -400};
+
+static const Shape shapes[] = {
+    {"circle", NULL, 0},
+    {"check", check, 3},
+    {"right", right, 2},
+    {"left", left, 2},
+    {"up", up, 2},
+    {"down", down, 2},
+    {"caret", caret, 3},
+    {"v", vee, 3},
+    {"z", zed, 4},
+    {"l", ell, 3},
+    {"triangle", triangle, 4},
+    {"rectangle", rectangle, 5},
+    {"arrow", arrow, 5},
+    {"u", NULL, 0},
+};
+
+static uint8_t arena[4096];
+static stroke_Recorder rec;
+static double angle, scale;
+static uint32_t timestamp;
+static uint16_t drawn; // points of the last stroke
+
+static void point(double x, double y)
+{
+    double c = cos(angle), s = sin(angle);
+    double px = (x * c - y * s) * scale + rand() % (2 * NOISE + 1) - NOISE;
+    double py = (x * s + y * c) * scale + rand() % (2 * NOISE + 1) - NOISE;
+    stroke_addPoint(&rec, (uint16_t)(3500 + px), (uint16_t)(3000 + py), 60, timestamp);
+    timestamp += 12 + (timestamp & 1);
+    drawn++;
+}
+
+static void arc(double cx, double cy, double r, double from, double to)
+{
+    uint16_t n = (uint16_t)(fabs(to - from) * r * scale / STEP) + 1;
+    for (uint16_t i = 0; i <= n; i++)
+    {
+        double a = from + (to - from) * i / n;
+        point(cx + r * cos(a), cy + r * sin(a));
+    }
+}
+
+static void draw(const Shape *shape)
+{
+    stroke_clear(&rec);
+    drawn = 0;
+    angle = (rand() % 31 - 15) * PI / 180;
+    scale = 0.4 + (rand() % 101) / 100.0;
+    if (strcmp(shape->name, "circle") == 0)
+        arc(0, 0, 1000, PI / 2, (rand() & 1) ? 2.5 * PI : -1.5 * PI); // either direction
+    else if (strcmp(shape->name, "u") == 0)
+        arc(0, 0, 800, PI, 2 * PI);
+    else
+    {
+        point(shape->corners[0], shape->corners[1]);
+        for (uint8_t i = 1; i < shape->count; i++)
+        {
+            const double *a = &shape->corners[2 * i - 2], *b = &shape->corners[2 * i];
+            uint16_t n = (uint16_t)(hypot(b[0] - a[0], b[1] - a[1]) * scale / STEP) + 1;
+            for (uint16_t k = 1; k <= n; k++)
+                point(a[0] + (b[0] - a[0]) * k / n, a[1] + (b[1] - a[1]) * k / n);
+        }
+    }
+    stroke_end(&rec);
+}
+
+static double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main()
+{
+    static recognize_Template budget[MAX_TEMPLATES];
+    recognize_Vector vector;
+    uint16_t correct = 0, total = 0;
+    volatile int32_t sink = 0;
+
+    stroke_init(&rec, arena, sizeof(arena));
+    srand(1);
+    printf("shape      correct  lowest score  most confused with\n");
+    for (uint8_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++)
+    {
+        uint16_t ok = 0, lowest = UINT16_MAX;
+        const char *confused = "-";
+        for (uint16_t k = 0; k < SAMPLES; k++)
+        {
+            draw(&shapes[s]);
+            total++;
+            if (!recognize_fromStroke(&rec, 0, &vector))
+                continue;
+            recognize_Result r = recognize_match(&vector, recognize_defaultTemplates, recognize_defaultTemplateCount);
+            if ((r.index >= 0) && (strcmp(recognize_defaultTemplates[r.index].name, shapes[s].name) == 0))
+            {
+                ok++;
+                if (r.score < lowest)
+                    lowest = r.score;
+            }
+            else if (r.index >= 0)
+            {
+                confused = recognize_defaultTemplates[r.index].name;
+            }
+        }
+        correct += ok;
+        printf("%-10s %3u/%u %10.3f    %s\n", shapes[s].name, ok, SAMPLES, lowest / 32767.0, confused);
+    }
+    printf("total      %u/%u\n", correct, total);
+
+    // the last stroke drawn is the one timed
+    double t0 = seconds();
+    for (uint32_t i = 0; i < REPEAT; i++)
+        sink += recognize_fromStroke(&rec, 0, &vector);
+    double t1 = seconds();
+    for (uint32_t i = 0; i < REPEAT; i++)
+        sink += recognize_match(&vector, recognize_defaultTemplates, recognize_defaultTemplateCount).index;
+    double t2 = seconds();
+    for (uint8_t i = 0; i < MAX_TEMPLATES; i++) // the default set repeated, as a full table of own templates
+        budget[i] = recognize_defaultTemplates[i % recognize_defaultTemplateCount];
+    for (uint32_t i = 0; i < REPEAT; i++)
+        sink += recognize_match(&vector, budget, MAX_TEMPLATES).index;
+    double t3 = seconds();
+    (void)sink;
+
+    printf("resample and normalise %3u points: %6.2f us\n", drawn, (t1 - t0) * 1e6 / REPEAT);
+    printf("match, %2u default templates:     %6.2f us\n", recognize_defaultTemplateCount, (t2 - t1) * 1e6 / REPEAT);
+    printf("match, %2u templates:             %6.2f us\n", MAX_TEMPLATES, (t3 - t2) * 1e6 / REPEAT);
+
+    bool ok = (correct * 100 >= total * 95);
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
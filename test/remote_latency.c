@@ -0,0 +1,133 @@
+//  Stream vs remote reporting: age of the newest sample at each control loop tick
+//
+// The fake device writes the sample time into X, so the age of every
+// position the loop uses is known exactly. In stream mode the device
+// samples at 80 packets/s on its own clock, in remote mode a timer polls
+// LEAD_US before each tick, leaving time for the 0xEB request and the
+// 7 byte answer.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <math.h>
+#include "fake_ps2.h"
+#include "touchpad.h"
+
+#define RUN_US 10000000 // simulated time per case
+#define STEP_US 200     // application work between two driver calls
+#define LEAD_US 9000    // poll this long before the tick: 1 ms request + 7 bytes + margin
+#define CODE_US 100     // resolution of the time stamp carried in X
+#define CODE_WRAP 6000
+
+typedef struct
+{
+    double meanMs, minMs, maxMs, jitterMs; // age of the used sample at the tick
+    double stale;                          // ticks without a new sample
+    double stampErrMs;                     // worst touchpad_getPacketTimestamp() error
+    uint32_t ticks;                        // 0 if the device could not be set up
+} Result;
+
+static uint8_t source(uint32_t sample_us, uint8_t *p)
+{
+    if (!(fake_getModeByte() & 0x80)) // relative mode until the absolute mode is set, no movement
+    {
+        p[0] = 0x08;
+        p[1] = p[2] = 0;
+        return 3;
+    }
+    uint16_t code = (sample_us / CODE_US) % CODE_WRAP;
+    fake_encodeAbsolute(1000 + code, 3000, 60, 4, 0, p);
+    return 6;
+}
+
+static Result run(touchpad_ReportingMode reporting, uint32_t tick_us)
+{
+    Result res = {0, 1e9, 0, 0, 0, 0, 0};
+    touchpad_SynapticsMode mode = {.absolute = true, .highRate = true};
+    fake_reset(source);
+    if (touchapd_init() || touchpad_setSynapticsMode(&mode) || touchpad_setReportingMode(reporting))
+        return res;
+
+    uint32_t start = fake_now();
+    uint32_t next_tick = start + tick_us;
+    uint32_t next_poll = next_tick - LEAD_US;
+    int32_t sample = -1, used = -1; // time code of the newest / of the previously used sample
+    double sum = 0, sum2 = 0;
+    uint32_t stale = 0;
+
+    while (fake_now() - start < RUN_US)
+    {
+        fake_advance(STEP_US);
+        if ((reporting == eRemoteReporting) && (fake_now() >= next_poll))
+        {
+            touchpad_remotePoll(); // the TIM6 interrupt
+            next_poll += tick_us;
+        }
+        touchpad_processCommands();
+
+        uint16_t x, y;
+        uint8_t z;
+        while (touchapd_readAbsolutePosition(&x, &y, &z) == TOUCHPAD_OK)
+        {
+            sample = x - 1000;
+            uint32_t stamp_ms = touchpad_getPacketTimestamp();
+            // the real sample time, the newest one with this code
+            uint32_t now_code = (fake_now() / CODE_US) % CODE_WRAP;
+            uint32_t back = (now_code + CODE_WRAP - (uint32_t)sample) % CODE_WRAP;
+            uint32_t sample_ms = (fake_now() - back * CODE_US) / 1000;
+            double err = fabs((double)stamp_ms - (double)sample_ms);
+            if (err > res.stampErrMs)
+                res.stampErrMs = err;
+        }
+
+        if (fake_now() >= next_tick)
+        {
+            if (sample >= 0)
+            {
+                uint32_t tick_code = (next_tick / CODE_US) % CODE_WRAP;
+                double age = ((tick_code + CODE_WRAP - (uint32_t)sample) % CODE_WRAP) * CODE_US / 1000.0;
+                sum += age;
+                sum2 += age * age;
+                if (age < res.minMs)
+                    res.minMs = age;
+                if (age > res.maxMs)
+                    res.maxMs = age;
+                res.ticks++;
+                if (sample == used)
+                    stale++;
+                used = sample;
+            }
+            next_tick += tick_us;
+        }
+    }
+    if (res.ticks)
+    {
+        res.meanMs = sum / res.ticks;
+        res.jitterMs = sqrt(sum2 / res.ticks - res.meanMs * res.meanMs);
+        res.stale = 100.0 * stale / res.ticks;
+    }
+    return res;
+}
+
+int main()
+{
+    static const uint32_t ticks[] = {20000, 16667, 12500};
+    bool ok = true;
+
+    printf("age of the used sample at the control tick [ms], device at 80 packets/s in stream mode\n");
+    printf("mode    loop    mean    min    max  jitter  stale  stamp err\n");
+    for (uint8_t i = 0; i < sizeof(ticks) / sizeof(ticks[0]); i++)
+    {
+        Result s = run(eStreamReporting, ticks[i]);
+        Result r = run(eRemoteReporting, ticks[i]);
+        double hz = 1e6 / ticks[i];
+        printf("stream  %2.0f Hz %6.2f %6.2f %6.2f %7.2f %5.1f%% %6.1f\n", hz, s.meanMs, s.minMs, s.maxMs, s.jitterMs, s.stale, s.stampErrMs);
+        printf("remote  %2.0f Hz %6.2f %6.2f %6.2f %7.2f %5.1f%% %6.1f\n", hz, r.meanMs, r.minMs, r.maxMs, r.jitterMs, r.stale, r.stampErrMs);
+        // remote mode has to deliver a fresh sample of constant age every tick
+        if (!s.ticks || !r.ticks || (r.jitterMs > 0.5) || (r.stale > 0) || (r.maxMs > LEAD_US / 1000.0 + 1) || (r.stampErrMs > 1))
+            ok = false;
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
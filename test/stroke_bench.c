@@ -0,0 +1,165 @@
+//  Stroke recorder: bytes per point and encode/decode time
+//
+// Traces are sampled at 80 packets/s with ms time stamps, integer
+// positions and a few units of sensor noise, like absolute mode packets,
+// one is captured from the driver (agm_trace.h). Every stroke is read back
+// and compared with what was recorded.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "stroke.h"
+#include "agm_trace.h"
+
+#define PERIOD_US 12500 // 80 packets/s
+#define STROKE_MS 1500
+#define POINTS (STROKE_MS * 1000 / PERIOD_US)
+#define MAX_POINTS 200 // the captured trace is longer
+#define NOISE 2 // [units]
+#define REPEAT 2000
+#define PI 3.14159265358979
+
+typedef struct
+{
+    const char *name;
+    void (*position)(double t_ms, double *x, double *y);
+    bool irregular; // lost packets and fast pressure changes, the escaped encoding
+    const stroke_Point *captured; // replayed instead of position()
+    uint16_t count;
+} Trace;
+
+static void drag(double t, double *x, double *y) // slow, 200 units/s
+{
+    *x = 2500 + 0.2 * t;
+    *y = 3000 - 0.1 * t;
+}
+
+static void swipe(double t, double *x, double *y) // 1000 units/s
+{
+    *x = 1600 + 1.0 * t;
+    *y = 2000 + 0.5 * t;
+}
+
+static void fling(double t, double *x, double *y) // up to 3000 units/s
+{
+    double s = t / 1000;
+    *x = 1600 + 1000 * s * s;
+    *y = 4000 - 500 * s * s;
+}
+
+static void writing(double t, double *x, double *y) // loops of handwriting, 600 units across
+{
+    *x = 1800 + 1.2 * t + 300 * sin(2 * PI * t / 400);
+    *y = 3000 + 300 * cos(2 * PI * t / 400);
+}
+
+static const Trace traces[] = {
+    {"drag", drag, false, NULL, POINTS},
+    {"swipe", swipe, false, NULL, POINTS},
+    {"fling", fling, false, NULL, POINTS},
+    {"writing", writing, false, NULL, POINTS},
+    {"captured", NULL, false, agm_trace, sizeof(agm_trace) / sizeof(agm_trace[0])},
+    {"irregular", swipe, true, NULL, POINTS},
+};
+
+static stroke_Point points[MAX_POINTS];
+static uint8_t arena[64 * 1024];
+
+static void sample(const Trace *trace)
+{
+    if (trace->captured)
+    {
+        for (uint16_t k = 0; k < trace->count; k++)
+            points[k] = trace->captured[k];
+        return;
+    }
+    srand(1);
+    for (uint16_t k = 0; k < POINTS; k++)
+    {
+        double t = k * PERIOD_US / 1000.0, x, y;
+        trace->position(t, &x, &y);
+        points[k].x = (uint16_t)lround(x) + rand() % (2 * NOISE + 1) - NOISE;
+        points[k].y = (uint16_t)lround(y) + rand() % (2 * NOISE + 1) - NOISE;
+        points[k].z = 60 + rand() % 5 - 2;
+        points[k].timestamp = 100000 + (uint32_t)t;
+        if (trace->irregular)
+        {
+            points[k].z = (uint8_t)(40 + (k % 10) * 15);
+            points[k].timestamp += (k / 7) * 25; // every 7th interval has two packets lost
+        }
+    }
+    points[0].z = 20; // landing
+    points[1].z = 45;
+}
+
+static double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main()
+{
+    static stroke_Recorder rec;
+    bool ok = true;
+    uint32_t totalBytes = 0, totalPoints = 0;
+
+    printf("trace     bytes/point  encode ns/point  decode ns/point\n");
+    for (uint8_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++)
+    {
+        sample(&traces[i]);
+        uint16_t count = traces[i].count;
+
+        double t0 = seconds();
+        for (uint16_t r = 0; r < REPEAT; r++)
+        {
+            stroke_init(&rec, arena, sizeof(arena));
+            for (uint16_t k = 0; k < count; k++)
+                stroke_addPoint(&rec, points[k].x, points[k].y, points[k].z, points[k].timestamp);
+            stroke_end(&rec);
+        }
+        double t1 = seconds();
+        stroke_Reader reader;
+        stroke_Point p;
+        uint32_t sum = 0;
+        for (uint16_t r = 0; r < REPEAT; r++)
+        {
+            stroke_open(&rec, 0, &reader);
+            while (stroke_next(&reader, &p))
+                sum += p.x;
+        }
+        double t2 = seconds();
+
+        // round trip
+        uint16_t n = 0;
+        stroke_open(&rec, 0, &reader);
+        while (stroke_next(&reader, &p))
+        {
+            if ((n >= count) || (p.x != points[n].x) || (p.y != points[n].y) || (p.z != points[n].z) ||
+                (p.timestamp != points[n].timestamp))
+                ok = false;
+            n++;
+        }
+        if ((n != count) || (sum == 0))
+            ok = false;
+
+        // the first point lives in the index table, the rest in the arena
+        double bpp = (double)stroke_getUsedBytes(&rec) / (count - 1);
+        if (!traces[i].irregular) // worst case, not part of the average
+        {
+            totalBytes += stroke_getUsedBytes(&rec);
+            totalPoints += count - 1;
+        }
+        printf("%-9s %8.2f %14.1f %16.1f\n", traces[i].name, bpp,
+               (t1 - t0) * 1e9 / REPEAT / count, (t2 - t1) * 1e9 / REPEAT / count);
+    }
+    double bpp = (double)totalBytes / totalPoints;
+    printf("average   %8.2f bytes/point, %.1f KB per minute of touch at 80 packets/s\n", bpp, bpp * 80 * 60 / 1024);
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+// newlib header included by ssd1306.h, only the C++ guards are needed on the host
+#define _BEGIN_STD_C
+#define _END_STD_C
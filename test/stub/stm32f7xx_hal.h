@@ -0,0 +1,32 @@
+// Host stand-in for the STM32 HAL, only what the drivers under test use
+
+#ifndef __STM32F7XX_HAL_H__
+#define __STM32F7XX_HAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+    HAL_OK,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+    void *Instance;
+} I2C_HandleTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFu
+#define __ALIGNED(x) __attribute__((aligned(x)))
+// no DWT on the host, the drivers time with HAL_GetTick()
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+
+#endif
@@ -0,0 +1,121 @@
+//  Text rendering: the old per-pixel WriteChar against the column blitter
+//
+// Draws "Hello world" in Font_11x18 three ways: pixel by pixel from the
+// row-major table (the renderer before the blitter), with the blitter fed
+// from the row-major table and from the page-major one. The display RAM
+// behind the fake I2C bus has to be identical for both colours and every
+// vertical offset within a page, then the time per string is measured.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "fake_ssd1306.h"
+#include "ssd1306.h"
+
+#define ROUNDS 200000
+#define PAGES (SSD1306_HEIGHT / 8)
+
+typedef enum
+{
+    ePixels,
+    eRows,
+    ePaged
+} Renderer;
+
+static const char *names[] = {"per pixel (old)", "blitter, rows", "blitter, paged"};
+static char message[] = "Hello world";
+
+// ssd1306_WriteString() as it was before the blitter
+static void writeStringPixels(uint8_t x, uint8_t y, const char *str, FontDef Font, SSD1306_COLOR color)
+{
+    for (; *str; str++, x += Font.FontWidth)
+    {
+        if ((*str < 32) || (*str > 126) || (SSD1306_WIDTH < x + Font.FontWidth) || (SSD1306_HEIGHT < y + Font.FontHeight))
+            return;
+        for (uint32_t i = 0; i < Font.FontHeight; i++)
+        {
+            uint32_t b = Font.data[(*str - 32) * Font.FontHeight + i];
+            for (uint32_t j = 0; j < Font.FontWidth; j++)
+                ssd1306_DrawPixel(x + j, y + i, ((b << j) & 0x8000) ? color : (SSD1306_COLOR)!color);
+        }
+    }
+}
+
+static void render(Renderer r, uint8_t x, uint8_t y, SSD1306_COLOR color)
+{
+    if (r == ePixels)
+    {
+        writeStringPixels(x, y, message, Font_11x18_rows, color);
+        return;
+    }
+    ssd1306_SetCursor(x, y);
+    ssd1306_WriteString(message, (r == eRows) ? Font_11x18_rows : Font_11x18, color);
+}
+
+// draws on a patterned background and returns the display RAM as it is after the update
+static void capture(Renderer r, uint8_t x, uint8_t y, SSD1306_COLOR color, uint8_t *ram)
+{
+    ssd1306_Fill(Black);
+    for (uint8_t i = 0; i < SSD1306_WIDTH; i += 3) // the glyph cells have to overwrite it
+        ssd1306_DrawVLine(i, 0, SSD1306_HEIGHT - 1, White);
+    render(r, x, y, color);
+    ssd1306_UpdateScreen();
+    for (uint8_t p = 0; p < PAGES; p++)
+        for (uint8_t c = 0; c < SSD1306_WIDTH; c++)
+            ram[p * SSD1306_WIDTH + c] = fake_getDisplayByte(p, c);
+}
+
+static double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main()
+{
+    static uint8_t reference[SSD1306_BUFFER_SIZE], ram[SSD1306_BUFFER_SIZE];
+    uint16_t cases = 0, mismatches = 0;
+
+    ssd1306_Init();
+    for (uint8_t color = 0; color < 2; color++)
+    {
+        for (uint8_t y = 0; y + Font_11x18.FontHeight <= SSD1306_HEIGHT; y++)
+        {
+            for (uint8_t x = 0; x < 4; x += 3)
+            {
+                capture(ePixels, x, y, (SSD1306_COLOR)color, reference);
+                for (Renderer r = eRows; r <= ePaged; r++)
+                {
+                    capture(r, x, y, (SSD1306_COLOR)color, ram);
+                    cases++;
+                    if (memcmp(reference, ram, PAGES * SSD1306_WIDTH) != 0)
+                    {
+                        printf("%s differs: x %u, y %u, colour %u\n", names[r], x, y, color);
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+    printf("display RAM identical to the per pixel renderer in %u/%u cases\n", cases - mismatches, cases);
+
+    printf("\"%s\" in Font_11x18, y cycling through all page offsets\n", message);
+    double base = 0;
+    for (Renderer r = ePixels; r <= ePaged; r++)
+    {
+        double t0 = seconds();
+        for (uint32_t i = 0; i < ROUNDS; i++)
+            render(r, 0, i % (SSD1306_HEIGHT - Font_11x18.FontHeight + 1), White);
+        double ns = (seconds() - t0) * 1e9 / ROUNDS;
+        if (r == ePixels)
+            base = ns;
+        printf("%-16s %8.0f ns/string  %5.1fx\n", names[r], ns, base / ns);
+    }
+
+    printf("%s\n", mismatches ? "FAILED" : "OK");
+    return mismatches ? 1 : 0;
+}
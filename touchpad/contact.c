@@ -0,0 +1,130 @@
+//  Touch contact state machine for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "contact.h"
+
+static const contact_Config contact_DefaultConfig = {
+    .hoverOnZ = CONTACT_DEFAULT_HOVER_ON_Z,
+    .hoverOffZ = CONTACT_DEFAULT_HOVER_OFF_Z,
+    .touchOnZ = CONTACT_DEFAULT_TOUCH_ON_Z,
+    .touchOffZ = CONTACT_DEFAULT_TOUCH_OFF_Z,
+    .touchDwellMs = CONTACT_DEFAULT_TOUCH_DWELL,
+    .liftDwellMs = CONTACT_DEFAULT_LIFT_DWELL};
+
+void contact_init(contact_Tracker *tracker, const contact_Config *config)
+{
+    tracker->cfg = config ? *config : contact_DefaultConfig;
+    tracker->state = eContactNone;
+    tracker->pressPending = false;
+    tracker->pressSince = 0;
+    tracker->liftSince = 0;
+    tracker->x = tracker->y = 0;
+    tracker->z = 0;
+}
+
+static contact_EventType emit(contact_Tracker *tracker, contact_EventType type, uint32_t timestamp, contact_Event *event)
+{
+    if (event)
+    {
+        event->type = type;
+        event->x = tracker->x;
+        event->y = tracker->y;
+        event->z = tracker->z;
+        event->timestamp = timestamp;
+    }
+    return type;
+}
+
+// runs the transitions for the last stored sample at the given time
+static contact_EventType step(contact_Tracker *tracker, uint32_t now, contact_Event *event)
+{
+    const contact_Config *cfg = &tracker->cfg;
+    uint8_t z = tracker->z;
+
+    switch (tracker->state)
+    {
+    case eContactNone:
+    case eContactHover:
+        if (z >= cfg->touchOnZ)
+        {
+            if (!tracker->pressPending)
+            {
+                tracker->pressPending = true;
+                tracker->pressSince = now;
+            }
+            if (tracker->state == eContactNone) // a finger pressed right away passes hover too, touch down comes next call
+            {
+                tracker->state = eContactHover;
+                return emit(tracker, eContactHoverEnter, now, event);
+            }
+            if ((now - tracker->pressSince) >= cfg->touchDwellMs)
+            {
+                tracker->pressPending = false;
+                tracker->state = eContactTouching;
+                return emit(tracker, eContactTouchDown, tracker->pressSince, event);
+            }
+            return eContactNoEvent;
+        }
+        tracker->pressPending = false;
+        if ((tracker->state == eContactNone) && (z >= cfg->hoverOnZ))
+        {
+            tracker->state = eContactHover;
+            return emit(tracker, eContactHoverEnter, now, event);
+        }
+        if ((tracker->state == eContactHover) && (z < cfg->hoverOffZ))
+        {
+            tracker->state = eContactNone;
+            return emit(tracker, eContactHoverLeave, now, event);
+        }
+        return eContactNoEvent;
+
+    case eContactTouching:
+        if (z < cfg->touchOffZ)
+        {
+            tracker->state = eContactLifting;
+            tracker->liftSince = now;
+            return step(tracker, now, event); // zero dwell time lifts immediately
+        }
+        return eContactNoEvent;
+
+    case eContactLifting:
+        if (z >= cfg->touchOffZ) // pressure came back before the dwell time passed - just a dip
+        {
+            tracker->state = eContactTouching;
+            return eContactNoEvent;
+        }
+        if ((now - tracker->liftSince) >= cfg->liftDwellMs)
+        {
+            tracker->state = eContactHover; // a finger already gone leaves hover on the next call
+            return emit(tracker, eContactTouchUp, tracker->liftSince, event);
+        }
+        return eContactNoEvent;
+    }
+    return eContactNoEvent;
+}
+
+contact_EventType contact_update(contact_Tracker *tracker, uint16_t x, uint16_t y, uint8_t z,
+                                 uint32_t timestamp, contact_Event *event)
+{
+    if (z != 0) // no position is reported without a finger, keep the last one
+    {
+        tracker->x = x;
+        tracker->y = y;
+    }
+    tracker->z = z;
+    return step(tracker, timestamp, event);
+}
+
+// the device stops sending packets shortly after the finger is gone,
+// this lets the pending dwell times expire and the edges that follow come anyway
+contact_EventType contact_poll(contact_Tracker *tracker, uint32_t timestamp, contact_Event *event)
+{
+    return step(tracker, timestamp, event); // without a new sample only pending transitions can happen
+}
+
+contact_State contact_getState(const contact_Tracker *tracker)
+{
+    return tracker->state;
+}
@@ -0,0 +1,79 @@
+//  Touch contact state machine for the PS/2 Touchpad Driver
+//
+// Turns the raw pressure (pz) stream of the Synaptics® absolute mode into
+// debounced hover / touch-down / touch-up edges
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __CONTACT_H__
+#define __CONTACT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum // debounced state of the finger
+{
+    eContactNone,     // nothing near the sensor
+    eContactHover,    // finger close to the surface, but not touching it
+    eContactTouching, // finger pressed on the surface
+    eContactLifting   // pressure dropped, waiting for the lift dwell time to confirm
+} contact_State;
+
+// Edges are always nested: hover enter, any touch down / touch up pairs, hover leave.
+// One edge is reported per call, when a sample causes two the second one comes with the next call.
+typedef enum // edges reported by contact_update() and contact_poll()
+{
+    eContactNoEvent,
+    eContactHoverEnter,
+    eContactHoverLeave,
+    eContactTouchDown,
+    eContactTouchUp
+} contact_EventType;
+
+typedef struct
+{
+    contact_EventType type;
+    uint16_t x;         // position at the moment of the edge
+    uint16_t y;
+    uint8_t z;
+    uint32_t timestamp; // [ms] time the edge really happened (start of the dwell period)
+} contact_Event;
+
+typedef struct // thresholds use the pz scale documented in touchpad.h
+{
+    uint8_t hoverOnZ;      // pz >= hoverOnZ enters hover
+    uint8_t hoverOffZ;     // pz < hoverOffZ leaves hover
+    uint8_t touchOnZ;      // pz >= touchOnZ (for touchDwellMs) is a touch
+    uint8_t touchOffZ;     // pz < touchOffZ (for liftDwellMs) is a lift
+    uint16_t touchDwellMs; // minimum time the pressure has to stay above touchOnZ
+    uint16_t liftDwellMs;  // minimum time the pressure has to stay below touchOffZ
+} contact_Config;
+
+typedef struct // one instance per tracked finger, treat as opaque
+{
+    contact_Config cfg;
+    contact_State state;
+    bool pressPending;     // pz is above touchOnZ, but dwell time did not pass yet
+    uint32_t pressSince;
+    uint32_t liftSince;
+    uint16_t x, y;         // last reported sample
+    uint8_t z;
+} contact_Tracker;
+
+void contact_init(contact_Tracker *tracker, const contact_Config *config); // config = NULL selects defaults below
+contact_EventType contact_update(contact_Tracker *tracker, uint16_t x, uint16_t y, uint8_t z,
+                                 uint32_t timestamp, contact_Event *event); // call for every absolute packet
+contact_EventType contact_poll(contact_Tracker *tracker, uint32_t timestamp, contact_Event *event); // call when no packets arrive
+contact_State contact_getState(const contact_Tracker *tracker);
+
+// Default configuration
+#define CONTACT_DEFAULT_HOVER_ON_Z    8
+#define CONTACT_DEFAULT_HOVER_OFF_Z   4
+#define CONTACT_DEFAULT_TOUCH_ON_Z    30
+#define CONTACT_DEFAULT_TOUCH_OFF_Z   25
+#define CONTACT_DEFAULT_TOUCH_DWELL   12  // [ms] about one packet at 80 packets/s
+#define CONTACT_DEFAULT_LIFT_DWELL    25  // [ms] two packets at 80 packets/s
+
+#endif
@@ -0,0 +1,123 @@
+//  Kinetic (inertial) scrolling for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "kinetic.h"
+
+#define MIN_SAMPLES 3 // fewer points than this don't give a usable velocity
+
+void kinetic_init(kinetic_State *state, uint16_t tick_ms, uint32_t decay_q16, uint16_t window_ms)
+{
+    state->tickMs = tick_ms ? tick_ms : 1;
+    state->decay = decay_q16;
+    state->window = window_ms;
+    state->stopSpeed = 1 << 14; // a quarter of a unit per tick
+    state->head = 0;
+    state->count = 0;
+    kinetic_stop(state);
+}
+
+void kinetic_stop(kinetic_State *state)
+{
+    state->active = false;
+    state->vx = state->vy = 0;
+    state->remX = state->remY = 0;
+}
+
+void kinetic_touch(kinetic_State *state, uint16_t x, uint16_t y, uint32_t timestamp)
+{
+    if (state->active) // a new touch catches the content immediately
+    {
+        kinetic_stop(state);
+        state->count = 0;
+    }
+    state->x[state->head] = x;
+    state->y[state->head] = y;
+    state->t[state->head] = timestamp;
+    state->head = (state->head + 1) % KINETIC_HISTORY;
+    if (state->count < KINETIC_HISTORY)
+        state->count++;
+}
+
+// least squares slope of v(t), returns [units per tick, Q16]
+static int32_t fitVelocity(const int32_t *t, const int32_t *v, uint8_t n, uint16_t tick_ms)
+{
+    int32_t st = 0, sv = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        st += t[i];
+        sv += v[i];
+    }
+    int64_t stt = 0, stv = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        int32_t dt = t[i] * n - st; // scaled by n to stay in integers
+        int32_t dv = v[i] * n - sv;
+        stt += (int64_t)dt * dt;
+        stv += (int64_t)dt * dv;
+    }
+    if (stt == 0)
+        return 0;
+    return (int32_t)((stv * tick_ms * 65536) / stt);
+}
+
+void kinetic_release(kinetic_State *state)
+{
+    int32_t t[KINETIC_HISTORY], x[KINETIC_HISTORY], y[KINETIC_HISTORY];
+    uint8_t n = 0;
+    uint8_t last = (state->head + KINETIC_HISTORY - 1) % KINETIC_HISTORY;
+
+    // newest samples first, relative to the lift so the sums stay small
+    for (uint8_t i = 0; i < state->count; i++)
+    {
+        uint8_t k = (last + KINETIC_HISTORY - i) % KINETIC_HISTORY;
+        int32_t age = (int32_t)(state->t[last] - state->t[k]);
+        if (age > state->window)
+            break;
+        t[n] = -age;
+        x[n] = (int32_t)state->x[k] - state->x[last];
+        y[n] = (int32_t)state->y[k] - state->y[last];
+        n++;
+    }
+    state->count = 0;
+    if (n < MIN_SAMPLES)
+        return;
+
+    state->vx = fitVelocity(t, x, n, state->tickMs);
+    state->vy = fitVelocity(t, y, n, state->tickMs);
+    state->remX = state->remY = 0;
+    state->active = true;
+}
+
+static int16_t emit(int32_t *v, int32_t *rem)
+{
+    int32_t q = *rem + *v;
+    int32_t out = q / 65536; // truncates towards zero, the remainder keeps the sign
+    *rem = q - out * 65536;
+    return (int16_t)out;
+}
+
+bool kinetic_tick(kinetic_State *state, int16_t *dx, int16_t *dy)
+{
+    *dx = *dy = 0;
+    if (!state->active)
+        return false;
+
+    *dx = emit(&state->vx, &state->remX);
+    *dy = emit(&state->vy, &state->remY);
+
+    // integer exponential decay
+    state->vx = (int32_t)(((int64_t)state->vx * state->decay) >> 16);
+    state->vy = (int32_t)(((int64_t)state->vy * state->decay) >> 16);
+    int32_t ax = (state->vx < 0) ? -state->vx : state->vx;
+    int32_t ay = (state->vy < 0) ? -state->vy : state->vy;
+    if ((ax < state->stopSpeed) && (ay < state->stopSpeed))
+        state->active = false;
+    return true;
+}
+
+bool kinetic_isActive(const kinetic_State *state)
+{
+    return state->active;
+}
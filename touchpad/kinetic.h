@@ -0,0 +1,44 @@
+//  Kinetic (inertial) scrolling for the PS/2 Touchpad Driver
+//
+// Feed it with the absolute positions while the finger scrolls, after the
+// lift it keeps emitting exponentially decaying deltas on every timer tick.
+// No allocations, constant time per tick.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __KINETIC_H__
+#define __KINETIC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define KINETIC_HISTORY 8 // samples used by the release velocity fit
+
+typedef struct // treat as opaque
+{
+    uint16_t x[KINETIC_HISTORY]; // circular buffer of the latest samples
+    uint16_t y[KINETIC_HISTORY];
+    uint32_t t[KINETIC_HISTORY];
+    uint8_t head;
+    uint8_t count;
+    int32_t vx, vy;     // [units per tick, Q16] current velocity
+    int32_t remX, remY; // [Q16] fractional part not emitted yet
+    uint32_t decay;     // [Q16] velocity multiplier per tick
+    int32_t stopSpeed;  // [units per tick, Q16] motion ends below this speed
+    uint16_t tickMs;    // timer tick period
+    uint16_t window;    // [ms] only samples this close to the lift are fitted
+    bool active;
+} kinetic_State;
+
+void kinetic_init(kinetic_State *state, uint16_t tick_ms, uint32_t decay_q16, uint16_t window_ms);
+void kinetic_touch(kinetic_State *state, uint16_t x, uint16_t y, uint32_t timestamp); // every packet while touching, stops the motion
+void kinetic_release(kinetic_State *state);                                         // finger lifted, starts the motion
+void kinetic_stop(kinetic_State *state);
+bool kinetic_tick(kinetic_State *state, int16_t *dx, int16_t *dy);                  // true while moving
+bool kinetic_isActive(const kinetic_State *state);
+
+#define KINETIC_DECAY(x) ((uint32_t)((x) * 65536.0 + 0.5)) // e.g. KINETIC_DECAY(0.95), evaluated at compile time
+
+#endif
@@ -0,0 +1,120 @@
+//  Motion prediction for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "predict.h"
+
+void predict_init(predict_State *state, uint16_t max_horizon_ms, uint16_t max_gap_ms)
+{
+    state->maxHorizon = max_horizon_ms;
+    state->maxGap = max_gap_ms;
+    predict_reset(state);
+}
+
+void predict_reset(predict_State *state)
+{
+    state->count = 0;
+}
+
+void predict_addSample(predict_State *state, uint16_t x, uint16_t y, uint32_t timestamp)
+{
+    if ((state->count > 0) && (timestamp == state->t[state->count - 1]))
+    {
+        // two packets within the same millisecond, keep the newer position only
+        state->x[state->count - 1] = x;
+        state->y[state->count - 1] = y;
+        return;
+    }
+    if (state->count == PREDICT_HISTORY)
+    {
+        for (uint8_t i = 1; i < PREDICT_HISTORY; i++)
+        {
+            state->x[i - 1] = state->x[i];
+            state->y[i - 1] = state->y[i];
+            state->t[i - 1] = state->t[i];
+        }
+        state->count--;
+    }
+    state->x[state->count] = x;
+    state->y[state->count] = y;
+    state->t[state->count] = timestamp;
+    state->count++;
+}
+
+static uint16_t clampPosition(int32_t v)
+{
+    if (v < 0)
+        return 0;
+    if (v > UINT16_MAX)
+        return UINT16_MAX;
+    return (uint16_t)v;
+}
+
+static int32_t magnitude(int32_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+// extrapolates one axis, velocity is in Q8 units/ms, acceleration in Q16 units/ms^2
+static int32_t extrapolate(int32_t p, int32_t v, int64_t a, int32_t h)
+{
+    int32_t linear = (v * h) >> 8;
+    int32_t quadratic = (int32_t)((a * h * h) >> 17); // a * h^2 / 2
+    if (((quadratic < 0) ? -quadratic : quadratic) > ((linear < 0) ? -linear : linear))
+        quadratic = 0; // acceleration dominated estimates are mostly noise
+    return p + linear + quadratic;
+}
+
+bool predict_getPosition(const predict_State *state, uint32_t target_time, uint16_t *px, uint16_t *py)
+{
+    if (state->count == 0)
+        return false;
+    uint8_t n = state->count - 1;
+    *px = state->x[n];
+    *py = state->y[n];
+    if (state->count < PREDICT_HISTORY)
+        return false;
+
+    int32_t dt1 = (int32_t)(state->t[1] - state->t[0]);
+    int32_t dt2 = (int32_t)(state->t[2] - state->t[1]);
+    if ((dt1 <= 0) || (dt2 <= 0) || (dt1 > state->maxGap) || (dt2 > state->maxGap))
+        return false; // finger stopped reporting for a while, the old velocity is meaningless
+
+    int32_t travel_x = (int32_t)state->x[2] - state->x[0];
+    int32_t travel_y = (int32_t)state->y[2] - state->y[0];
+    if ((travel_x * travel_x + travel_y * travel_y) < PREDICT_MIN_TRAVEL * PREDICT_MIN_TRAVEL)
+        return false; // finger (nearly) still, extrapolating would only amplify the jitter
+
+    int32_t vx1 = (((int32_t)state->x[1] - state->x[0]) << 8) / dt1;
+    int32_t vy1 = (((int32_t)state->y[1] - state->y[0]) << 8) / dt1;
+    int32_t vx2 = (((int32_t)state->x[2] - state->x[1]) << 8) / dt2;
+    int32_t vy2 = (((int32_t)state->y[2] - state->y[1]) << 8) / dt2;
+
+    // confidence cutoff: a direction reversal means the extrapolation would overshoot
+    if (((int64_t)vx1 * vx2 + (int64_t)vy1 * vy2) < 0)
+        return false;
+
+    int32_t h = (int32_t)(target_time - state->t[2]);
+    if (h <= 0)
+        return false;
+    if (h > state->maxHorizon)
+        h = state->maxHorizon;
+
+    int32_t half_span = (dt1 + dt2) / 2; // time between the two velocity estimates
+    if (half_span == 0)
+        half_span = 1;
+    // Q16, a finger speeding up by 1000 units/s per second is 0.001 units/ms^2, zero in Q8
+    int64_t ax = ((int64_t)(vx2 - vx1) << 8) / half_span;
+    int64_t ay = ((int64_t)(vy2 - vy1) << 8) / half_span;
+
+    // a velocity change of |v| / dt can be only the 1 ms rounding of the time stamps
+    if (magnitude(vx2 - vx1) * dt2 <= magnitude(vx2))
+        ax = 0;
+    if (magnitude(vy2 - vy1) * dt2 <= magnitude(vy2))
+        ay = 0;
+
+    *px = clampPosition(extrapolate(state->x[2], vx2, ax, h));
+    *py = clampPosition(extrapolate(state->y[2], vy2, ay, h));
+    return true;
+}
@@ -0,0 +1,36 @@
+//  Motion prediction for the PS/2 Touchpad Driver
+//
+// Extrapolates the finger position to the time the frame becomes visible,
+// hiding the packet-to-display latency. Samples are added per packet,
+// the (more expensive) prediction is done once per frame.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __PREDICT_H__
+#define __PREDICT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define PREDICT_HISTORY 3     // samples needed for velocity and acceleration
+#define PREDICT_MIN_TRAVEL 16 // [units] less movement over the history is sensor noise, not motion
+
+typedef struct // treat as opaque
+{
+    uint16_t x[PREDICT_HISTORY]; // oldest first
+    uint16_t y[PREDICT_HISTORY];
+    uint32_t t[PREDICT_HISTORY];
+    uint8_t count;
+    uint16_t maxHorizon; // [ms] never predict further than this
+    uint16_t maxGap;     // [ms] older samples are not used for the estimate
+} predict_State;
+
+void predict_init(predict_State *state, uint16_t max_horizon_ms, uint16_t max_gap_ms);
+void predict_reset(predict_State *state);                                              // call at finger lift
+void predict_addSample(predict_State *state, uint16_t x, uint16_t y, uint32_t timestamp); // call for every packet
+bool predict_getPosition(const predict_State *state, uint32_t target_time, uint16_t *px, uint16_t *py);
+// returns false (and the last sample) when there is not enough data or the motion is unpredictable
+
+#endif
@@ -257,7 +257,8 @@ void ps2_sendByte(uint8_t byte)
     WAIT_FOR((!isCLKset()) && (!isDATAset()));
 }
 
-bool ps2_getACK()
+// drops all unread data and starts listening for the device's answer
+void ps2_startRx()
 {
     // flush the FIFO
     RxFIFOIn = RxFIFOOut = 0;
@@ -266,6 +267,11 @@ bool ps2_getACK()
     initSPI();
     SPI_BusyFlag = false;
     ps2_scheduleRx();
+}
+
+bool ps2_getACK()
+{
+    ps2_startRx();
     // receive the ACK data byte
     WAIT_FOR(!ps2_isDataAvaiable(1));
     uint8_t v = 0;
@@ -39,6 +39,7 @@ bool    ps2_readByte(uint8_t *byte);
 void    ps2_sendByte(uint8_t byte);
 bool    ps2_isDataAvaiable(uint8_t n_bytes);
 void    ps2_scheduleRx();
+void    ps2_startRx();
 bool    ps2_getACK();
 
 #endif
@@ -0,0 +1,223 @@
+//  Stroke shape recogniser for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "recognize.h"
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#endif
+
+#define POS_SHIFT 4        // resampling works on Q4 positions
+#define MIN_LENGTH (40 << POS_SHIFT) // [device units, Q4] shorter strokes are taps
+
+typedef struct
+{
+    bool measure;          // first pass only sums the path length
+    uint16_t count;        // input points seen
+    int32_t px, py;        // [Q4] previous point
+    uint32_t length;       // [Q4] whole path
+    uint32_t interval;     // [Q4] distance between output points
+    uint32_t walked;       // [Q4] since the last output point
+    uint8_t emitted;
+    int32_t x[RECOGNIZE_POINTS];
+    int32_t y[RECOGNIZE_POINTS];
+} Resampler;
+
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v)
+        bit >>= 2;
+    while (bit)
+    {
+        if (v >= res + bit)
+        {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+            res >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+static void emit(Resampler *rs, int32_t x, int32_t y)
+{
+    if (rs->emitted < RECOGNIZE_POINTS)
+    {
+        rs->x[rs->emitted] = x;
+        rs->y[rs->emitted] = y;
+        rs->emitted++;
+    }
+}
+
+static void resampleAdd(Resampler *rs, uint16_t x, uint16_t y)
+{
+    int32_t qx = (int32_t)x << POS_SHIFT;
+    int32_t qy = (int32_t)y << POS_SHIFT;
+    if (rs->count++ == 0)
+    {
+        if (!rs->measure)
+            emit(rs, qx, qy);
+        rs->px = qx;
+        rs->py = qy;
+        return;
+    }
+    int32_t dx = qx - rs->px;
+    int32_t dy = qy - rs->py;
+    uint32_t d = isqrt64((uint64_t)((int64_t)dx * dx + (int64_t)dy * dy));
+    if (rs->measure)
+    {
+        rs->length += d;
+    }
+    else
+    {
+        // drop output points along the segment, the same way as $1 does
+        uint32_t left = d;
+        while ((rs->walked + left >= rs->interval) && (left > 0) && (rs->emitted < RECOGNIZE_POINTS))
+        {
+            uint32_t step = rs->interval - rs->walked;
+            rs->px += (int32_t)(((int64_t)(qx - rs->px) * step) / left);
+            rs->py += (int32_t)(((int64_t)(qy - rs->py) * step) / left);
+            emit(rs, rs->px, rs->py);
+            left -= step;
+            rs->walked = 0;
+        }
+        rs->walked += left;
+    }
+    rs->px = qx;
+    rs->py = qy;
+}
+
+static void resampleStart(Resampler *rs, bool measure)
+{
+    rs->measure = measure;
+    rs->count = 0;
+    rs->walked = 0;
+    rs->emitted = 0;
+    if (measure)
+        rs->length = 0;
+    else
+        rs->interval = rs->length / (RECOGNIZE_POINTS - 1);
+}
+
+// centre the points and scale them to a vector of RECOGNIZE_NORM length
+static bool vectorize(Resampler *rs, recognize_Vector *out)
+{
+    while (rs->emitted < RECOGNIZE_POINTS) // rounding may leave the last point out
+        emit(rs, rs->px, rs->py);
+
+    int32_t cx = 0, cy = 0;
+    for (uint8_t i = 0; i < RECOGNIZE_POINTS; i++)
+    {
+        cx += rs->x[i];
+        cy += rs->y[i];
+    }
+    cx /= RECOGNIZE_POINTS;
+    cy /= RECOGNIZE_POINTS;
+
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < RECOGNIZE_POINTS; i++)
+    {
+        rs->x[i] -= cx;
+        rs->y[i] -= cy;
+        sum += (uint64_t)((int64_t)rs->x[i] * rs->x[i] + (int64_t)rs->y[i] * rs->y[i]);
+    }
+    uint32_t magnitude = isqrt64(sum);
+    if (magnitude == 0)
+        return false;
+
+    for (uint8_t i = 0; i < RECOGNIZE_POINTS; i++)
+    {
+        out->v[2 * i] = (int16_t)(((int64_t)rs->x[i] * RECOGNIZE_NORM) / magnitude);
+        out->v[2 * i + 1] = (int16_t)(((int64_t)rs->y[i] * RECOGNIZE_NORM) / magnitude);
+    }
+    return true;
+}
+
+bool recognize_fromPoints(const uint16_t *x, const uint16_t *y, uint16_t count, recognize_Vector *out)
+{
+    Resampler rs;
+    resampleStart(&rs, true);
+    for (uint16_t i = 0; i < count; i++)
+        resampleAdd(&rs, x[i], y[i]);
+    if (rs.length < MIN_LENGTH)
+        return false;
+
+    resampleStart(&rs, false);
+    for (uint16_t i = 0; i < count; i++)
+        resampleAdd(&rs, x[i], y[i]);
+    return vectorize(&rs, out);
+}
+
+bool recognize_fromStroke(const stroke_Recorder *rec, uint8_t index, recognize_Vector *out)
+{
+    // two passes over the compressed stroke, no copy of the raw points is needed
+    Resampler rs;
+    stroke_Reader reader;
+    stroke_Point p;
+
+    resampleStart(&rs, true);
+    if (!stroke_open(rec, index, &reader))
+        return false;
+    while (stroke_next(&reader, &p))
+        resampleAdd(&rs, p.x, p.y);
+    if (rs.length < MIN_LENGTH)
+        return false;
+
+    resampleStart(&rs, false);
+    stroke_open(rec, index, &reader);
+    while (stroke_next(&reader, &p))
+        resampleAdd(&rs, p.x, p.y);
+    return vectorize(&rs, out);
+}
+
+// a = sum(x*tx + y*ty), b = sum(x*ty - y*tx)
+static void dotProducts(const recognize_Vector *v, const recognize_Vector *t, int32_t *a, int32_t *b)
+{
+    int32_t sa = 0, sb = 0;
+#if defined(__ARM_FEATURE_DSP)
+    for (uint8_t i = 0; i < RECOGNIZE_POINTS; i++)
+    {
+        sa = __smlad(v->packed[i], t->packed[i], sa);
+        sb = __smlsdx(v->packed[i], t->packed[i], sb);
+    }
+#else
+    for (uint8_t i = 0; i < RECOGNIZE_POINTS; i++)
+    {
+        int32_t x = v->v[2 * i], y = v->v[2 * i + 1];
+        int32_t tx = t->v[2 * i], ty = t->v[2 * i + 1];
+        sa += x * tx + y * ty;
+        sb += x * ty - y * tx;
+    }
+#endif
+    *a = sa;
+    *b = sb;
+}
+
+recognize_Result recognize_match(const recognize_Vector *vector, const recognize_Template *templates, uint8_t count)
+{
+    recognize_Result result = {-1, 0};
+    uint32_t best = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int32_t a, b;
+        dotProducts(vector, &templates[i].vector, &a, &b);
+        uint32_t score;
+        if (templates[i].rotationInvariant) // cosine at the optimal rotation angle
+            score = isqrt64((uint64_t)((int64_t)a * a + (int64_t)b * b));
+        else
+            score = (a > 0) ? (uint32_t)a : 0;
+        if (score > best)
+        {
+            best = score;
+            result.index = i;
+        }
+    }
+    // RECOGNIZE_NORM^2 = 2^28 is the similarity of identical shapes
+    result.score = (best >> 13) > 32767 ? 32767 : (uint16_t)(best >> 13);
+    return result;
+}
@@ -0,0 +1,50 @@
+//  Stroke shape recogniser for the PS/2 Touchpad Driver
+//
+// Protractor ($1 family) template matcher in fixed point. A stroke is
+// resampled to RECOGNIZE_POINTS equidistant points, centred and scaled to
+// a unit vector, so matching a template is a single dot product. With
+// rotation invariance the best rotation angle is solved in closed form
+// (no trigonometry). Templates are const, so they stay in flash.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __RECOGNIZE_H__
+#define __RECOGNIZE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "stroke.h"
+
+#define RECOGNIZE_POINTS 32
+#define RECOGNIZE_NORM 16384 // length of a normalised vector, the dot product fits in int32
+
+typedef union
+{
+    int16_t v[2 * RECOGNIZE_POINTS];   // x0, y0, x1, y1, ...
+    uint32_t packed[RECOGNIZE_POINTS]; // one point per word for the dual 16-bit MAC
+} recognize_Vector;
+
+typedef struct
+{
+    const char *name;
+    uint8_t id;
+    bool rotationInvariant; // match in any orientation (e.g. circle), otherwise only as drawn (e.g. check mark)
+    recognize_Vector vector;
+} recognize_Template;
+
+typedef struct
+{
+    int16_t index;  // into the template table, -1 if nothing matched
+    uint16_t score; // [Q15] cosine similarity, 32767 = identical shape
+} recognize_Result;
+
+bool recognize_fromPoints(const uint16_t *x, const uint16_t *y, uint16_t count, recognize_Vector *out);
+bool recognize_fromStroke(const stroke_Recorder *rec, uint8_t index, recognize_Vector *out); // false for a tap or too short stroke
+recognize_Result recognize_match(const recognize_Vector *vector, const recognize_Template *templates, uint8_t count);
+
+extern const recognize_Template recognize_defaultTemplates[];
+extern const uint8_t recognize_defaultTemplateCount;
+
+#endif
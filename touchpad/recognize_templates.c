@@ -0,0 +1,35 @@
+//  Default recogniser templates for the PS/2 Touchpad Driver
+//
+// Generated by running recognize_fromPoints() on ideal shapes drawn in
+// device coordinates (Y grows upwards). Record your own with
+// recognize_fromStroke() and paste the vectors here.
+//
+// 14 shapes in 15 entries (the circle in both directions). Matching is
+// sized for up to 32 templates per display frame, the rest of that budget
+// is left for application specific ones: every extra template also adds a
+// chance of a wrong match. test/recognize_bench.c measures both.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "recognize.h"
+
+const recognize_Template recognize_defaultTemplates[] = {
+    {"circle", 0, true, {.v = {1, 2809, -581, 2748, -1140, 2573, -1654, 2289, -2098, 1907, -2457, 1443, -2715, 917, -2863, 350, -2894, -235, -2805, -814, -2602, -1364, -2292, -1862, -1889, -2287, -1408, -2622, -869, -2855, -295, -2972, 290, -2973, 865, -2856, 1404, -2625, 1885, -2290, 2289, -1865, 2600, -1368, 2804, -818, 2894, -239, 2864, 345, 2717, 912, 2460, 1440, 2101, 1903, 1658, 2287, 1145, 2571, 585, 2747, 2, 2808}}},
+    {"circle", 0, true, {.v = {1, 2809, 584, 2747, 1143, 2571, 1656, 2288, 2100, 1904, 2459, 1441, 2716, 914, 2864, 347, 2894, -237, 2804, -817, 2600, -1366, 2291, -1864, 1887, -2289, 1405, -2624, 866, -2856, 292, -2973, -293, -2973, -868, -2855, -1406, -2623, -1888, -2288, -2291, -1863, -2601, -1365, -2804, -815, -2894, -236, -2864, 348, -2716, 915, -2458, 1442, -2099, 1905, -1656, 2288, -1142, 2572, -582, 2747, 0, 2808}}},
+    {"check", 1, false, {.v = {-3284, 468, -3107, 101, -2923, -262, -2740, -626, -2561, -992, -2377, -1355, -2194, -1719, -2012, -2084, -1832, -2449, -1648, -2813, -1436, -2877, -1193, -2552, -949, -2227, -706, -1902, -462, -1577, -215, -1255, 28, -930, 267, -602, 511, -277, 755, 47, 998, 372, 1245, 695, 1489, 1020, 1733, 1344, 1972, 1673, 2216, 1998, 2463, 2320, 2706, 2645, 2950, 2970, 3194, 3295, 3438, 3620, 3681, 3945}}},
+    {"right", 2, false, {.v = {-4862, 0, -4548, 0, -4234, 0, -3921, 0, -3607, 0, -3293, 0, -2980, 0, -2666, 0, -2352, 0, -2038, 0, -1725, 0, -1411, 0, -1097, 0, -784, 0, -470, 0, -156, 0, 156, 0, 470, 0, 784, 0, 1097, 0, 1411, 0, 1725, 0, 2038, 0, 2352, 0, 2666, 0, 2980, 0, 3293, 0, 3607, 0, 3921, 0, 4234, 0, 4548, 0, 4862, 0}}},
+    {"left", 3, false, {.v = {4862, 0, 4548, 0, 4234, 0, 3921, 0, 3607, 0, 3293, 0, 2980, 0, 2666, 0, 2352, 0, 2038, 0, 1725, 0, 1411, 0, 1097, 0, 784, 0, 470, 0, 156, 0, -156, 0, -470, 0, -784, 0, -1097, 0, -1411, 0, -1725, 0, -2038, 0, -2352, 0, -2666, 0, -2980, 0, -3293, 0, -3607, 0, -3921, 0, -4234, 0, -4548, 0, -4862, 0}}},
+    {"up", 4, false, {.v = {0, -4862, 0, -4548, 0, -4234, 0, -3921, 0, -3607, 0, -3293, 0, -2980, 0, -2666, 0, -2352, 0, -2038, 0, -1725, 0, -1411, 0, -1097, 0, -784, 0, -470, 0, -156, 0, 156, 0, 470, 0, 784, 0, 1097, 0, 1411, 0, 1725, 0, 2038, 0, 2352, 0, 2666, 0, 2980, 0, 3293, 0, 3607, 0, 3921, 0, 4234, 0, 4548, 0, 4862}}},
+    {"down", 5, false, {.v = {0, 4862, 0, 4548, 0, 4234, 0, 3921, 0, 3607, 0, 3293, 0, 2980, 0, 2666, 0, 2352, 0, 2038, 0, 1725, 0, 1411, 0, 1097, 0, 784, 0, 470, 0, 156, 0, -156, 0, -470, 0, -784, 0, -1097, 0, -1411, 0, -1725, 0, -2038, 0, -2352, 0, -2666, 0, -2980, 0, -3293, 0, -3607, 0, -3921, 0, -4234, 0, -4548, 0, -4862}}},
+    {"caret", 6, false, {.v = {-2918, -3769, -2730, -3267, -2541, -2764, -2354, -2261, -2164, -1759, -1979, -1256, -1788, -754, -1601, -251, -1413, 250, -1221, 752, -1036, 1255, -845, 1757, -659, 2260, -469, 2762, -279, 3264, -94, 3767, 94, 3769, 280, 3266, 470, 2764, 660, 2262, 846, 1759, 1036, 1256, 1221, 754, 1413, 252, 1601, -249, 1789, -752, 1979, -1254, 2164, -1757, 2355, -2259, 2542, -2762, 2730, -3264, 2922, -3766}}},
+    {"v", 7, false, {.v = {-2917, 3769, -2731, 3266, -2542, 2764, -2355, 2261, -2166, 1759, -1980, 1256, -1790, 754, -1601, 252, -1414, -250, -1223, -751, -1037, -1254, -848, -1756, -660, -2259, -472, -2761, -281, -3263, -95, -3766, 95, -3768, 281, -3265, 471, -2763, 661, -2262, 847, -1759, 1037, -1257, 1223, -754, 1414, -252, 1602, 250, 1790, 752, 1980, 1254, 2166, 1757, 2355, 2258, 2542, 2762, 2731, 3264, 2921, 3765}}},
+    {"z", 8, false, {.v = {-2770, 2770, -2162, 2770, -1554, 2770, -946, 2770, -337, 2770, 270, 2770, 878, 2770, 1486, 2770, 2094, 2770, 2702, 2770, 2387, 2386, 1953, 1952, 1519, 1518, 1085, 1085, 652, 651, 218, 217, -215, -216, -648, -649, -1082, -1083, -1516, -1517, -1950, -1950, -2383, -2384, -2704, -2771, -2096, -2771, -1488, -2771, -879, -2771, -271, -2771, 336, -2771, 944, -2771, 1552, -2771, 2161, -2771, 2769, -2771}}},
+    {"l", 9, false, {.v = {-793, 5099, -793, 4719, -793, 4339, -793, 3958, -793, 3578, -793, 3198, -793, 2818, -793, 2438, -793, 2057, -793, 1677, -793, 1297, -793, 917, -793, 536, -793, 156, -793, -223, -793, -603, -793, -984, -793, -1364, -793, -1744, -793, -2124, -767, -2478, -387, -2478, -7, -2478, 373, -2478, 753, -2478, 1133, -2478, 1513, -2478, 1894, -2478, 2274, -2478, 2654, -2478, 3034, -2478, 3415, -2478}}},
+    {"triangle", 10, true, {.v = {1, 4090, -300, 3487, -602, 2885, -904, 2282, -1206, 1679, -1508, 1076, -1809, 472, -2109, -130, -2411, -733, -2712, -1336, -3015, -1939, -3023, -2362, -2351, -2362, -1679, -2362, -1007, -2362, -335, -2362, 336, -2362, 1008, -2362, 1680, -2362, 2352, -2362, 3024, -2362, 3014, -1943, 2712, -1340, 2411, -737, 2110, -134, 1809, 469, 1508, 1072, 1206, 1675, 904, 2278, 601, 2880, 300, 3483, 2, 4088}}},
+    {"rectangle", 11, true, {.v = {-2410, 2410, -2410, 1767, -2410, 1124, -2410, 482, -2410, -160, -2410, -802, -2410, -1445, -2410, -2088, -2249, -2570, -1607, -2570, -964, -2570, -321, -2570, 320, -2570, 963, -2570, 1605, -2570, 2248, -2570, 2570, -2249, 2570, -1607, 2570, -964, 2570, -321, 2570, 320, 2570, 963, 2570, 1605, 2570, 2248, 2089, 2410, 1446, 2410, 804, 2410, 161, 2410, -480, 2410, -1123, 2410, -1766, 2410, -2408, 2410}}},
+    {"arrow", 12, false, {.v = {-6420, -155, -5797, -155, -5174, -155, -4551, -155, -3928, -155, -3305, -155, -2683, -155, -2060, -155, -1437, -155, -814, -155, -191, -155, 431, -155, 1054, -155, 1677, -155, 2299, -155, 2922, -155, 2595, 235, 2151, 680, 1707, 1123, 1263, 1567, 819, 2012, 897, 1934, 1341, 1490, 1785, 1045, 2229, 602, 2673, 158, 2865, -282, 2420, -727, 1976, -1171, 1532, -1615, 1087, -2060, 643, -2504}}},
+    {"u", 13, false, {.v = {-3674, 2267, -3657, 1895, -3599, 1527, -3507, 1166, -3379, 816, -3216, 481, -3017, 166, -2790, -129, -2533, -398, -2252, -642, -1945, -854, -1619, -1033, -1276, -1180, -921, -1292, -557, -1370, -186, -1406, 186, -1407, 557, -1370, 921, -1292, 1276, -1181, 1619, -1034, 1945, -854, 2252, -643, 2533, -399, 2791, -130, 3017, 164, 3216, 480, 3380, 815, 3508, 1165, 3600, 1526, 3658, 1894, 3679, 2266}}},
+};
+
+const uint8_t recognize_defaultTemplateCount = sizeof(recognize_defaultTemplates) / sizeof(recognize_defaultTemplates[0]);
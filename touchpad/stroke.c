@@ -0,0 +1,229 @@
+//  Stroke recorder for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "stroke.h"
+
+#define MAX_POINT_BYTES 24 // 1 (escape) + 4 varints of up to 5 bytes, rounded up
+#define POINT_ESCAPE 0x80  // first byte of a point that doesn't fit the packed form, four varints follow
+
+static uint8_t putVarint(uint8_t *buf, int32_t value)
+{
+    uint32_t zz = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); // zigzag: small magnitudes give small codes
+    uint8_t n = 0;
+    while (zz >= 0x80)
+    {
+        buf[n++] = (uint8_t)(zz | 0x80);
+        zz >>= 7;
+    }
+    buf[n++] = (uint8_t)zz;
+    return n;
+}
+
+static int32_t getVarint(const stroke_Recorder *rec, uint32_t *pos)
+{
+    uint32_t zz = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+    do
+    {
+        b = rec->arena[*pos % rec->size];
+        (*pos)++;
+        zz |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while ((b & 0x80) && (shift < 35));
+    return (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+}
+
+static int32_t signExtend(uint32_t bits, uint8_t width)
+{
+    uint32_t sign = 1UL << (width - 1);
+    return (int32_t)((bits & ((sign << 1) - 1)) ^ sign) - (int32_t)sign;
+}
+
+// The change of the X and Y deltas (the finger keeps its speed between two packets), the Z delta
+// and the change of the sampling interval mostly fit two bytes: xxxxxyyy yyzzzztt (two's complement),
+// ddx = -16 is the escape
+static uint8_t putPoint(uint8_t *buf, int32_t ddx, int32_t ddy, int32_t dz, int32_t dstep)
+{
+    if ((ddx >= -15) && (ddx <= 15) && (ddy >= -16) && (ddy <= 15) && (dz >= -8) && (dz <= 7) &&
+        (dstep >= -2) && (dstep <= 1))
+    {
+        uint16_t packed = (uint16_t)(((ddx & 0x1F) << 11) | ((ddy & 0x1F) << 6) | ((dz & 0x0F) << 2) | (dstep & 0x03));
+        buf[0] = (uint8_t)(packed >> 8);
+        buf[1] = (uint8_t)packed;
+        return 2;
+    }
+    buf[0] = POINT_ESCAPE;
+    uint8_t n = 1 + putVarint(buf + 1, ddx);
+    n += putVarint(buf + n, ddy);
+    n += putVarint(buf + n, dz);
+    return n + putVarint(buf + n, dstep);
+}
+
+static void getPoint(const stroke_Recorder *rec, uint32_t *pos, int32_t *ddx, int32_t *ddy, int32_t *dz, int32_t *dstep)
+{
+    uint8_t b = rec->arena[*pos % rec->size];
+    (*pos)++;
+    if ((b & 0xF8) == POINT_ESCAPE)
+    {
+        *ddx = getVarint(rec, pos);
+        *ddy = getVarint(rec, pos);
+        *dz = getVarint(rec, pos);
+        *dstep = getVarint(rec, pos);
+        return;
+    }
+    uint16_t packed = (uint16_t)((b << 8) | rec->arena[*pos % rec->size]);
+    (*pos)++;
+    *ddx = signExtend(packed >> 11, 5);
+    *ddy = signExtend(packed >> 6, 5);
+    *dz = signExtend(packed >> 2, 4);
+    *dstep = signExtend(packed, 2);
+}
+
+void stroke_clear(stroke_Recorder *rec)
+{
+    rec->head = rec->tail = 0;
+    rec->first = 0;
+    rec->count = 0;
+    rec->open = false;
+    rec->truncated = false;
+}
+
+void stroke_init(stroke_Recorder *rec, uint8_t *arena, uint32_t size)
+{
+    rec->arena = arena;
+    rec->size = size;
+    rec->evicted = 0;
+    stroke_clear(rec);
+}
+
+static void evictOldest(stroke_Recorder *rec)
+{
+    rec->first = (rec->first + 1) % STROKE_MAX_STROKES;
+    rec->count--;
+    rec->tail = rec->count ? rec->entry[rec->first].start : rec->head;
+    rec->evicted++;
+}
+
+static stroke_Entry *newest(stroke_Recorder *rec)
+{
+    return &rec->entry[(rec->first + rec->count - 1) % STROKE_MAX_STROKES];
+}
+
+void stroke_addPoint(stroke_Recorder *rec, uint16_t x, uint16_t y, uint8_t z, uint32_t timestamp)
+{
+    stroke_Point p = {x, y, z, timestamp};
+
+    if (!rec->open)
+    {
+        if (rec->count == STROKE_MAX_STROKES)
+            evictOldest(rec);
+        stroke_Entry *e = &rec->entry[(rec->first + rec->count) % STROKE_MAX_STROKES];
+        rec->count++;
+        e->start = rec->head;
+        e->points = 1;
+        e->first = p;
+        rec->last = p;
+        rec->dx = rec->dy = 0;
+        rec->step = 0;
+        rec->open = true;
+        rec->truncated = false;
+        return;
+    }
+
+    stroke_Entry *e = newest(rec);
+    if (rec->truncated || (e->points == UINT16_MAX))
+        return;
+
+    uint8_t buf[MAX_POINT_BYTES];
+    int32_t dx = (int32_t)x - rec->last.x;
+    int32_t dy = (int32_t)y - rec->last.y;
+    int32_t step = (int32_t)(timestamp - rec->last.timestamp);
+    uint8_t n = putPoint(buf, dx - rec->dx, dy - rec->dy, (int32_t)z - rec->last.z, step - rec->step);
+
+    while (rec->size - (rec->head - rec->tail) < n)
+    {
+        if (rec->count == 1) // only the open stroke left, keep its beginning
+        {
+            rec->truncated = true;
+            return;
+        }
+        evictOldest(rec);
+    }
+
+    for (uint8_t i = 0; i < n; i++)
+        rec->arena[(rec->head + i) % rec->size] = buf[i];
+    rec->head += n;
+    e->points++;
+    rec->last = p;
+    rec->dx = dx;
+    rec->dy = dy;
+    rec->step = step;
+}
+
+void stroke_end(stroke_Recorder *rec)
+{
+    rec->open = false;
+}
+
+uint8_t stroke_getCount(const stroke_Recorder *rec)
+{
+    return rec->count;
+}
+
+uint32_t stroke_getUsedBytes(const stroke_Recorder *rec)
+{
+    return rec->head - rec->tail;
+}
+
+uint32_t stroke_getEvicted(const stroke_Recorder *rec)
+{
+    return rec->evicted;
+}
+
+bool stroke_open(const stroke_Recorder *rec, uint8_t index, stroke_Reader *reader)
+{
+    if (index >= rec->count)
+        return false;
+    const stroke_Entry *e = &rec->entry[(rec->first + index) % STROKE_MAX_STROKES];
+    reader->rec = rec;
+    reader->start = e->start;
+    reader->pos = e->start;
+    reader->remaining = e->points;
+    reader->last = e->first;
+    reader->dx = reader->dy = 0;
+    reader->step = 0;
+    reader->started = false;
+    return true;
+}
+
+bool stroke_next(stroke_Reader *reader, stroke_Point *point)
+{
+    const stroke_Recorder *rec = reader->rec;
+    if (reader->remaining == 0)
+        return false;
+    if ((int32_t)(reader->start - rec->tail) < 0) // overwritten by newer strokes
+    {
+        reader->remaining = 0;
+        return false;
+    }
+
+    if (reader->started) // the first point comes from the index, the rest are deltas
+    {
+        int32_t ddx, ddy, dz, dstep;
+        getPoint(rec, &reader->pos, &ddx, &ddy, &dz, &dstep);
+        reader->dx += ddx;
+        reader->dy += ddy;
+        reader->last.x += reader->dx;
+        reader->last.y += reader->dy;
+        reader->last.z += dz;
+        reader->step += dstep;
+        reader->last.timestamp += reader->step;
+    }
+    reader->started = true;
+    reader->remaining--;
+    *point = reader->last;
+    return true;
+}
@@ -0,0 +1,78 @@
+//  Stroke recorder for the PS/2 Touchpad Driver
+//
+// Stores the finger path of the absolute mode in a fixed arena. The first
+// point of a stroke is kept in the index table, every next one as the
+// change of its X and Y deltas, the Z delta and the change of the sampling
+// interval packed into 2 bytes, escaped to varints when they don't fit:
+// 2.1 bytes instead of 9 per point (test/stroke_bench.c).
+// Points are stored losslessly, so that is ~10 KB per minute of touch at 80
+// packets/s: an 8 KB arena keeps the last ~50 s of strokes, not minutes.
+// When the arena or the index is full the oldest strokes are dropped.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __STROKE_H__
+#define __STROKE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define STROKE_MAX_STROKES 32 // index table size
+
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t z;
+    uint32_t timestamp; // [ms]
+} stroke_Point;
+
+typedef struct
+{
+    uint32_t start;      // logical arena offset of the second point
+    uint16_t points;
+    stroke_Point first;
+} stroke_Entry;
+
+typedef struct // treat as opaque
+{
+    uint8_t *arena;
+    uint32_t size;
+    uint32_t head;       // logical write offset, arena index is offset % size
+    uint32_t tail;       // logical offset of the oldest stored byte
+    stroke_Entry entry[STROKE_MAX_STROKES];
+    uint8_t first;       // oldest entry
+    uint8_t count;       // stored strokes including the open one
+    bool open;           // the newest stroke is still being recorded
+    bool truncated;      // the open stroke alone filled the arena, further points are dropped
+    stroke_Point last;   // previous point of the open stroke
+    int32_t dx, dy;      // its movement since the point before it
+    int32_t step;        // [ms] time since the point before it
+    uint32_t evicted;    // strokes dropped since stroke_init()
+} stroke_Recorder;
+
+typedef struct // streaming reader of one stroke
+{
+    const stroke_Recorder *rec;
+    uint32_t start;
+    uint32_t pos;
+    uint16_t remaining;
+    stroke_Point last;
+    int32_t dx, dy;
+    int32_t step;
+    bool started;
+} stroke_Reader;
+
+void stroke_init(stroke_Recorder *rec, uint8_t *arena, uint32_t size);
+void stroke_addPoint(stroke_Recorder *rec, uint16_t x, uint16_t y, uint8_t z, uint32_t timestamp); // starts a new stroke if none is open
+void stroke_end(stroke_Recorder *rec); // call at lift
+void stroke_clear(stroke_Recorder *rec);
+uint8_t stroke_getCount(const stroke_Recorder *rec);
+uint32_t stroke_getUsedBytes(const stroke_Recorder *rec);
+uint32_t stroke_getEvicted(const stroke_Recorder *rec);
+bool stroke_open(const stroke_Recorder *rec, uint8_t index, stroke_Reader *reader); // index 0 = oldest stroke
+bool stroke_next(stroke_Reader *reader, stroke_Point *point); // false at the end or when the stroke was evicted meanwhile
+
+#endif
@@ -3,48 +3,372 @@
 // 2019 by ppelikan
 // github.com/ppelikan
 
+#include <string.h>
 #include "ps2.h"
 #include "touchpad.h"
 
+#define CMD_TIMEOUT 30 // [ms] for the ACK or response, same as the PS/2 layer uses
+
+// Synaptics® mode byte bits
+#define SYN_MODE_ABSOLUTE   0x80
+#define SYN_MODE_HIGH_RATE  0x40
+#define SYN_MODE_DISGEST_EW 0x04 // DisGest without W mode, EWmode with W mode
+#define SYN_MODE_W          0x01
+
+#define SYN_W_NARROW_FINGER 4 // W values 4..15 are the finger width
+
+#define GUEST_QUEUE_SIZE 4 // pass-through reports waiting for touchpad_readGuestMovement()
+
 static volatile touchapd_Mode touchpad_CurrentMode = eUninitialized;
+static touchpad_DeviceType touchpad_DeviceId = eStandardMouse;
+static uint8_t touchpad_PacketSize = 3; // relative mode packet length, depends on touchpad_DeviceId
+static volatile touchpad_ReportingMode touchpad_Reporting = eStreamReporting;
+static bool touchpad_CommandActive = false;             // a command is in progress, remote polling has to wait
+static volatile bool touchpad_PollDue = false;          // set by touchpad_remotePoll(), the request is sent from thread context
+static volatile bool touchpad_RemoteAckPending = false; // the ACK of 0xEB is still in front of the packet
+static volatile uint32_t touchpad_PollTimestamp = 0;
+static uint32_t touchpad_PacketTimestamp = 0;
+static uint8_t touchpad_SynModeByte = SYN_MODE_ABSOLUTE; // used when entering the absolute mode
+static touchpad_SynapticsInfo touchpad_SynInfo;
+static bool touchpad_SynInfoValid = false;
+static touchpad_Contact touchpad_Secondary; // last secondary finger from an extended W packet
+static touchpad_MouseReport touchpad_GuestQueue[GUEST_QUEUE_SIZE]; // pass-through device reports
+static uint8_t touchpad_GuestIn = 0, touchpad_GuestOut = 0;
+static bool touchpad_GuestAckPending = false; // the guest's ACK of the forwarded 0xF4 has not arrived yet
+static uint8_t touchpad_PendingPacket[6]; // primary packet read while looking for guest packets
+static uint8_t touchpad_PendingW;
+static bool touchpad_PendingValid = false;
+
+// absolute to relative pointer (see touchpad_readVirtualMovement())
+static touchpad_PointerConfig touchpad_Pointer = {
+    .divider = 8,
+    .accelThreshold = 40,
+    .accelGain = 16,
+    .maxGain = 4,
+    .touchZ = 30,
+    .landPackets = 1};
+static bool touchpad_PtrTouching = false;
+static uint16_t touchpad_PtrLastX, touchpad_PtrLastY;
+static int32_t touchpad_PtrRemX, touchpad_PtrRemY; // sub-count remainders, nothing is lost by the division
+static uint8_t touchpad_PtrSettle;                  // packets to ignore after landing
+static uint8_t touchpad_PtrLastW = SYN_W_NARROW_FINGER;
+
+// command transaction in progress (see touchpad_beginCommands())
+static uint8_t touchpad_CmdBytes[TOUCHPAD_MAX_COMMAND_BYTES];
+static uint8_t touchpad_CmdCount = 0;
+static uint8_t touchpad_CmdNext = 0;
+static uint8_t *touchpad_CmdResponse = NULL;
+static uint8_t touchpad_CmdResponseLen = 0;
+static bool touchpad_CmdAcked = false; // all bytes acknowledged, waiting for the response
+static uint32_t touchpad_CmdSentAt = 0;
+
+static void touchpad_sendNextCommandByte()
+{
+    ps2_sendByte(touchpad_CmdBytes[touchpad_CmdNext]);
+    ps2_startRx();
+    touchpad_CmdSentAt = HAL_GetTick();
+}
+
+static int8_t touchpad_finishCommands(int8_t result)
+{
+    touchpad_CmdCount = 0;
+    touchpad_CommandActive = false;
+    return result;
+}
+
+// sends the Read Data request of a due poll, runs in thread context like the command path
+static void touchpad_sendRemotePoll()
+{
+    if (!touchpad_PollDue)
+        return;
+    touchpad_PollDue = false;
+    if ((touchpad_Reporting != eRemoteReporting) || touchpad_CommandActive)
+        return; // skipped, the next timer period polls again
+    ps2_sendByte(0xEB); // Read Data
+    touchpad_PollTimestamp = HAL_GetTick();
+    touchpad_RemoteAckPending = true;
+    ps2_startRx(); // drops the previous packet if nobody read it, so data is never older than one period
+}
+
+int8_t touchpad_beginCommands(const uint8_t *bytes, uint8_t count, uint8_t *response, uint8_t response_len)
+{
+    if (touchpad_CommandActive)
+        return TOUCHPAD_BUSY;
+    if ((count == 0) || (count > TOUCHPAD_MAX_COMMAND_BYTES))
+        return TOUCHPAD_SET_MODE_FAILED;
+    touchpad_CommandActive = true; // from now on remote polling and packet readers keep off the FIFO
+    memcpy(touchpad_CmdBytes, bytes, count);
+    touchpad_CmdCount = count;
+    touchpad_CmdNext = 0;
+    touchpad_CmdResponse = response;
+    touchpad_CmdResponseLen = response ? response_len : 0;
+    touchpad_CmdAcked = false;
+    touchpad_sendNextCommandByte();
+    return TOUCHPAD_OK;
+}
+
+int8_t touchpad_processCommands()
+{
+    touchpad_sendRemotePoll();
+    if (!touchpad_CommandActive || (touchpad_CmdCount == 0))
+        return TOUCHPAD_OK;
+    bool timeout = ((HAL_GetTick() - touchpad_CmdSentAt) > CMD_TIMEOUT);
+
+    if (!touchpad_CmdAcked)
+    {
+        uint8_t v;
+        if (!ps2_readByte(&v))
+            return timeout ? touchpad_finishCommands(TOUCHPAD_SET_MODE_FAILED) : TOUCHPAD_BUSY;
+        if (v != 0xFA) // check ACK
+            return touchpad_finishCommands(TOUCHPAD_SET_MODE_FAILED);
+        if (++touchpad_CmdNext < touchpad_CmdCount)
+        {
+            touchpad_sendNextCommandByte();
+            return TOUCHPAD_BUSY;
+        }
+        touchpad_CmdAcked = true;
+        touchpad_CmdSentAt = HAL_GetTick();
+        timeout = false;
+    }
+
+    if (!ps2_isDataAvaiable(touchpad_CmdResponseLen))
+        return timeout ? touchpad_finishCommands(TOUCHPAD_SET_MODE_FAILED) : TOUCHPAD_BUSY;
+    for (uint8_t i = 0; i < touchpad_CmdResponseLen; i++)
+        ps2_readByte(&touchpad_CmdResponse[i]);
+    return touchpad_finishCommands(TOUCHPAD_OK);
+}
+
+// blocking version of the above, used where the caller can't do anything else anyway
+static int8_t touchpad_runCommands(const uint8_t *bytes, uint8_t count, uint8_t *response, uint8_t response_len)
+{
+    int8_t err = touchpad_beginCommands(bytes, count, response, response_len);
+    while (err == TOUCHPAD_OK)
+    {
+        err = touchpad_processCommands();
+        if (err != TOUCHPAD_BUSY)
+            return err;
+        err = TOUCHPAD_OK;
+    }
+    return err;
+}
+
+static int8_t touchpad_sendCommand(uint8_t cmd)
+{
+    return touchpad_runCommands(&cmd, 1, NULL, 0);
+}
+
+// in remote mode every packet is preceded by the ACK of the 0xEB request
+static bool touchpad_isPacketAvailable(uint8_t n_bytes)
+{
+    if (touchpad_RemoteAckPending)
+    {
+        uint8_t ack;
+        if (!ps2_readByte(&ack))
+            return false;
+        touchpad_RemoteAckPending = false;
+        if (ack != 0xFA)
+            return false; // request not accepted, no packet will follow
+    }
+    return ps2_isDataAvaiable(n_bytes);
+}
+
+static void touchpad_stampPacket()
+{
+    if (touchpad_Reporting == eRemoteReporting)
+        touchpad_PacketTimestamp = touchpad_PollTimestamp;
+    else
+        touchpad_PacketTimestamp = HAL_GetTick();
+}
+
+static int8_t touchpad_readDeviceId(uint8_t *id)
+{
+    static const uint8_t cmd = 0xF2; // Get Device ID
+    return touchpad_runCommands(&cmd, 1, id, 1);
+}
+
+// the magic sample rate sequence that unlocks the IntelliMouse extensions
+static int8_t touchpad_knock(uint8_t r1, uint8_t r2, uint8_t r3)
+{
+    const uint8_t sequence[] = {0xF3, r1, 0xF3, r2, 0xF3, r3};
+    return touchpad_runCommands(sequence, sizeof(sequence), NULL, 0);
+}
+
+// devices that don't know the extensions simply keep reporting ID 0x00
+static void touchpad_detectExtensions()
+{
+    uint8_t id = eStandardMouse;
+    touchpad_DeviceId = eStandardMouse;
+    if (touchpad_knock(200, 100, 80) || touchpad_readDeviceId(&id) || (id != eWheelMouse))
+        return;
+    touchpad_DeviceId = eWheelMouse;
+    if (touchpad_knock(200, 200, 80) || touchpad_readDeviceId(&id) || (id != eFiveButtonMouse))
+        return;
+    touchpad_DeviceId = eFiveButtonMouse;
+}
 
 int8_t touchapd_init()
 {
-    ps2_sendByte(0xFF); // Reset
-    if (!ps2_getACK())
+    touchpad_Reporting = eStreamReporting; // reset always returns to stream mode
+    touchpad_SynInfoValid = false;
+    touchpad_RemoteAckPending = false;
+    if (touchpad_sendCommand(0xFF)) // Reset
+        return TOUCHPAD_SET_MODE_FAILED;
+    touchpad_detectExtensions();
+    touchpad_PacketSize = (touchpad_DeviceId == eStandardMouse) ? 3 : 4;
+    if (touchapd_setSampleRate(eSampleRate100fps)) // knocking always leaves the rate at 80, restore the default
         return TOUCHPAD_SET_MODE_FAILED;
-    ps2_sendByte(0xF4); // Enable Data Reporting
-    if (!ps2_getACK())
+    if (touchpad_sendCommand(0xF4)) // Enable Data Reporting
         return TOUCHPAD_SET_MODE_FAILED;
     touchpad_CurrentMode = eMovementMode;
     return TOUCHPAD_OK;
 }
 
-static int8_t touchpad_turnAbsoluteModeON()
+static uint32_t touchpad_ModeSwitchTime = 0;
+
+// Synaptics® special commands pass their 8 bit argument as four
+// 2 bit Set Resolution (0xE8) parameters, most significant first
+static void touchpad_encodeSliced(uint8_t arg, uint8_t *out)
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        out[2 * i] = 0xE8;
+        out[2 * i + 1] = (arg >> (6 - 2 * i)) & 0x03;
+    }
+}
+
+static int8_t touchpad_writeModeByte(uint8_t mode_byte)
 {
     // this only works for Synaptics® devices
-    static const uint8_t unlock_sequence[] = {0xE8, 0x02, 0xE8, 0x00, 0xE8, 0x00, 0xE8, 0x00, 0xF3, 0x14};
-    size_t cnt = sizeof(unlock_sequence) / sizeof(unlock_sequence[0]);
-    for (size_t i = 0; i < cnt; i++)
+    uint8_t sequence[10];
+    touchpad_encodeSliced(mode_byte, sequence);
+    sequence[8] = 0xF3; // Set Sample Rate 20 stores the argument as the mode byte
+    sequence[9] = 0x14;
+    return touchpad_runCommands(sequence, sizeof(sequence), NULL, 0);
+}
+
+// sends a Synaptics® information query, the device answers with 3 bytes
+static int8_t touchpad_querySliced(uint8_t query, uint8_t *response)
+{
+    uint8_t sequence[9];
+    touchpad_encodeSliced(query, sequence);
+    sequence[8] = 0xE9; // Status Request returns the query result
+    return touchpad_runCommands(sequence, sizeof(sequence), response, 3);
+}
+
+int8_t touchpad_querySynaptics(touchpad_SynapticsInfo *info)
+{
+    uint8_t r[3];
+    if (touchpad_SynInfoValid)
     {
-        ps2_sendByte(unlock_sequence[i]);
-        if (!ps2_getACK())
+        *info = touchpad_SynInfo;
+        return TOUCHPAD_OK;
+    }
+    memset(info, 0, sizeof(*info));
+    if (touchpad_querySliced(0x00, r)) // Identify TouchPad
+        return TOUCHPAD_SET_MODE_FAILED;
+    info->isSynaptics = (r[1] == 0x47);
+    if (!info->isSynaptics)
+        return TOUCHPAD_NOT_SUPPORTED;
+    info->minorVersion = r[0];
+    info->majorVersion = r[2] & 0x0F;
+
+    if (touchpad_querySliced(0x02, r)) // Read Capabilities
+        return TOUCHPAD_SET_MODE_FAILED;
+    info->capabilities = ((uint32_t)r[0] << 16) | ((uint32_t)r[1] << 8) | r[2];
+    if ((info->capabilities & SYN_CAP_EXTENDED) && (((info->capabilities >> 20) & 0x07) >= 4))
+    {
+        if (touchpad_querySliced(0x0C, r)) // Extended Capabilities (0x0C), needs 4 or more extended queries
             return TOUCHPAD_SET_MODE_FAILED;
+        info->extCapabilities = ((uint32_t)r[0] << 16) | ((uint32_t)r[1] << 8) | r[2];
     }
+    touchpad_SynInfo = *info;
+    touchpad_SynInfoValid = true;
+    return TOUCHPAD_OK;
+}
+
+int8_t touchpad_setSynapticsMode(const touchpad_SynapticsMode *mode)
+{
+    touchpad_SynapticsInfo info;
+    int8_t err = touchpad_querySynaptics(&info);
+    if (err)
+        return err;
+
+    // W mode is available only on devices with extended capabilities and
+    // bit 2 of the mode byte means DisGest without W mode and EWmode with it
+    if ((mode->wMode || mode->extendedW) && !(info.capabilities & SYN_CAP_EXTENDED))
+        return TOUCHPAD_NOT_SUPPORTED;
+    if (mode->extendedW && (!mode->wMode || !(info.extCapabilities & SYN_EXTCAP_ADV_GESTURE)))
+        return TOUCHPAD_NOT_SUPPORTED;
+    if (mode->disableGestures && mode->wMode)
+        return TOUCHPAD_NOT_SUPPORTED;
+
+    uint8_t mode_byte = 0x00;
+    if (mode->absolute)
+        mode_byte |= SYN_MODE_ABSOLUTE;
+    if (mode->highRate)
+        mode_byte |= SYN_MODE_HIGH_RATE;
+    if (mode->disableGestures || mode->extendedW)
+        mode_byte |= SYN_MODE_DISGEST_EW;
+    if (mode->wMode)
+        mode_byte |= SYN_MODE_W;
+
+    if (touchpad_writeModeByte(mode_byte))
+        return TOUCHPAD_SET_MODE_FAILED;
+    touchpad_SynModeByte = mode_byte | SYN_MODE_ABSOLUTE; // reused by touchpad_setMode(eAbsoluteMode)
+    touchpad_CurrentMode = mode->absolute ? eAbsoluteMode : eMovementMode;
+    return TOUCHPAD_OK;
+}
+
+static int8_t touchpad_turnAbsoluteModeON()
+{
+    if (touchpad_writeModeByte(touchpad_SynModeByte))
+        return TOUCHPAD_SET_MODE_FAILED;
     touchpad_CurrentMode = eAbsoluteMode;
     return TOUCHPAD_OK;
 }
 
+// leaves the absolute mode without resetting the device,
+// relative mode settings (resolution, rate, scaling) stay untouched
+static int8_t touchpad_turnAbsoluteModeOFF()
+{
+    if (touchpad_writeModeByte(0x00)) // relative mode
+        return TOUCHPAD_SET_MODE_FAILED;
+    touchpad_CurrentMode = eMovementMode;
+    return TOUCHPAD_OK;
+}
+
 int8_t touchpad_setMode(touchapd_Mode mode)
 {
-    if ((touchpad_CurrentMode == eUninitialized) || (mode == eMovementMode))
-        if (touchapd_init())
-            return TOUCHPAD_SET_MODE_FAILED;
+    uint32_t start = HAL_GetTick();
+    int8_t err = TOUCHPAD_SET_MODE_FAILED;
 
-    if (mode == eAbsoluteMode)
-        return touchpad_turnAbsoluteModeON();
+    if (touchpad_CommandActive) // e.g. touchpad_beginConfig() still running, try again later
+        return TOUCHPAD_BUSY;
 
-    return TOUCHPAD_OK;
+    if (touchpad_CurrentMode != eUninitialized)
+    {
+        if (mode == eAbsoluteMode)
+            err = touchpad_turnAbsoluteModeON();
+        else if (touchpad_CurrentMode == eAbsoluteMode)
+            err = touchpad_turnAbsoluteModeOFF();
+        else
+            err = TOUCHPAD_OK; // already there, keeps the reporting mode and touchpad_beginConfig() settings
+    }
+
+    if (err) // first use, or the device got lost - do it the slow way
+    {
+        err = touchapd_init();
+        if (!err && (mode == eAbsoluteMode))
+            err = touchpad_turnAbsoluteModeON();
+    }
+
+    touchpad_ModeSwitchTime = HAL_GetTick() - start;
+    return err ? TOUCHPAD_SET_MODE_FAILED : TOUCHPAD_OK;
+}
+
+uint32_t touchpad_getModeSwitchTime()
+{
+    return touchpad_ModeSwitchTime;
 }
 
 touchapd_Mode touchpad_getCurrentMode()
@@ -52,30 +376,109 @@ touchapd_Mode touchpad_getCurrentMode()
     return touchpad_CurrentMode;
 }
 
+touchpad_DeviceType touchpad_getDeviceType()
+{
+    return touchpad_DeviceId;
+}
+
 int8_t touchapd_setSampleRate(touchpad_SampleRate value)
 {
     HAL_Delay(1);
-    ps2_sendByte(0xF3);
-    if (!ps2_getACK())
+    const uint8_t cmd[] = {0xF3, (uint8_t)value}; // Set Sample Rate
+    return touchpad_runCommands(cmd, sizeof(cmd), NULL, 0);
+}
+
+// queues the whole configuration as one transaction, finish it with touchpad_processCommands()
+int8_t touchpad_beginConfig(const touchpad_Config *config)
+{
+    const uint8_t cmd[] = {
+        0xE8, (uint8_t)config->resolution, // Set Resolution
+        (uint8_t)config->scaling,          // Set Scaling 1:1 / 2:1
+        0xF3, (uint8_t)config->sampleRate  // Set Sample Rate
+    };
+    return touchpad_beginCommands(cmd, sizeof(cmd), NULL, 0);
+}
+
+int8_t touchpad_readStatus(touchpad_Status *status)
+{
+    static const uint8_t cmd = 0xE9; // Status Request
+    uint8_t st[3];
+    if (touchpad_runCommands(&cmd, 1, st, sizeof(st)))
         return TOUCHPAD_SET_MODE_FAILED;
-    ps2_sendByte((uint8_t)value);
-    if (!ps2_getACK())
+    status->remoteMode = ((st[0] & 0x40) == 0x40);
+    status->enabled = ((st[0] & 0x20) == 0x20);
+    status->scaling = (st[0] & 0x10) ? eScaling2to1 : eScaling1to1;
+    status->buttons = 0;
+    if (st[0] & 0x04)
+        status->buttons |= TOUCHPAD_BUTTON_LEFT;
+    if (st[0] & 0x02)
+        status->buttons |= TOUCHPAD_BUTTON_MIDDLE;
+    if (st[0] & 0x01)
+        status->buttons |= TOUCHPAD_BUTTON_RIGHT;
+    status->resolution = (touchpad_Resolution)(st[1] & 0x03);
+    status->sampleRate = st[2];
+    return TOUCHPAD_OK;
+}
+
+int8_t touchpad_setReportingMode(touchpad_ReportingMode mode)
+{
+    if (touchpad_sendCommand((mode == eRemoteReporting) ? 0xF0 : 0xEA)) // Set Remote Mode / Set Stream Mode
         return TOUCHPAD_SET_MODE_FAILED;
+    touchpad_RemoteAckPending = false;
+    touchpad_Reporting = mode;
     return TOUCHPAD_OK;
 }
 
-int8_t touchapd_readMovement(int16_t *px, int16_t *py, bool *button)
+touchpad_ReportingMode touchpad_getReportingMode()
+{
+    return touchpad_Reporting;
+}
+
+// requests one packet, call it periodically from a timer interrupt
+// only marks the poll as due, sending takes milliseconds and is done by touchpad_processCommands()
+void touchpad_remotePoll()
+{
+    touchpad_PollDue = true;
+}
+
+uint32_t touchpad_getPacketTimestamp()
+{
+    return touchpad_PacketTimestamp;
+}
+
+// decodes the standard 3 byte relative packet
+static void touchpad_decodeMovement(uint8_t dt, uint8_t dx, uint8_t dy, touchpad_MouseReport *report)
+{
+    uint8_t fx, fy;
+    if (dt & 0x10)
+        fx = 0xff;
+    else
+        fx = 0x00;
+    if (dt & 0x20)
+        fy = 0xff;
+    else
+        fy = 0x00;
+    report->dy = (int16_t)((uint16_t)(fy << 8) | (uint16_t)dy);
+    report->dx = (int16_t)((uint16_t)(fx << 8) | (uint16_t)dx);
+    report->overflow = ((dt & 0xC0) != 0x00);
+    if (dt & 0x40) // X overflow, the real value didn't fit in 9 bits - use the maximum in the right direction
+        report->dx = (dt & 0x10) ? -256 : 255;
+    if (dt & 0x80) // Y overflow
+        report->dy = (dt & 0x20) ? -256 : 255;
+    report->buttons = dt & (TOUCHPAD_BUTTON_LEFT | TOUCHPAD_BUTTON_RIGHT | TOUCHPAD_BUTTON_MIDDLE);
+}
+
+int8_t touchpad_readMouseReport(touchpad_MouseReport *report)
 {
     if (touchpad_CurrentMode != eMovementMode)
         return TOUCHPAD_WRONG_MODE_ERROR;
-    if (!ps2_isDataAvaiable(3))
+    if (touchpad_CommandActive || !touchpad_isPacketAvailable(touchpad_PacketSize))
     {
         ps2_scheduleRx();
         return TOUCHPAD_NO_DATA_TO_READ;
     }
 
-    uint8_t dt, dx, dy;
-    uint8_t fx, fy;
+    uint8_t dt, dx, dy, dz = 0;
     ps2_readByte(&dt);
     if (!(dt & 0x08)) // verify if data is correct
     {
@@ -83,47 +486,380 @@ int8_t touchapd_readMovement(int16_t *px, int16_t *py, bool *button)
     }
     ps2_readByte(&dx);
     ps2_readByte(&dy);
+    if (touchpad_PacketSize == 4)
+        ps2_readByte(&dz);
+    touchpad_stampPacket();
 
-    if (dt & 0x10)
-        fx = 0xff;
-    else
-        fx = 0x00;
-    if (dt & 0x20)
-        fy = 0xff;
+    touchpad_decodeMovement(dt, dx, dy, report);
+
+    if (touchpad_DeviceId == eFiveButtonMouse)
+    {
+        report->wheel = (int8_t)((dz & 0x08) ? (dz | 0xF0) : (dz & 0x0F)); // 4 bit signed value
+        if (dz & 0x10)
+            report->buttons |= TOUCHPAD_BUTTON_4;
+        if (dz & 0x20)
+            report->buttons |= TOUCHPAD_BUTTON_5;
+    }
     else
-        fy = 0x00;
-    *py = (int16_t)((uint16_t)(fy << 8) | (uint16_t)dy);
-    *px = (int16_t)((uint16_t)(fx << 8) | (uint16_t)dx);
-    *button = ((dt & 0x01) == 0x01);
+        report->wheel = (int8_t)dz;
 
     return TOUCHPAD_OK;
 }
 
-int8_t touchapd_readAbsolutePosition(uint16_t *px, uint16_t *py, uint8_t *pz)
+int8_t touchapd_readMovement(int16_t *px, int16_t *py, bool *button)
+{
+    touchpad_MouseReport report;
+    int8_t err = touchpad_readMouseReport(&report);
+    if (err)
+        return err;
+    *px = report.dx;
+    *py = report.dy;
+    if (button)
+        *button = ((report.buttons & TOUCHPAD_BUTTON_LEFT) == TOUCHPAD_BUTTON_LEFT);
+    return TOUCHPAD_OK;
+}
+
+static int16_t saturate16(int32_t v)
+{
+    if (v > INT16_MAX)
+        return INT16_MAX;
+    if (v < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)v;
+}
+
+// merges all packets waiting in the FIFO, call it once per frame
+int8_t touchpad_readAccumulatedMovement(touchpad_Movement *movement)
+{
+    static uint8_t buttons = 0; // state reported at the previous call
+    int32_t dx = 0, dy = 0, wheel = 0;
+    touchpad_MouseReport report;
+    int8_t err;
+
+    movement->pressed = movement->released = 0;
+    movement->packets = 0;
+    movement->overflow = false;
+    while ((err = touchpad_readMouseReport(&report)) != TOUCHPAD_NO_DATA_TO_READ)
+    {
+        if (err == TOUCHPAD_CORRUPT_DATA_ERROR) // just resynchronize on the next byte
+            continue;
+        if (err)
+            return err;
+        dx += report.dx;
+        dy += report.dy;
+        wheel += report.wheel;
+        movement->pressed |= report.buttons & ~buttons; // short clicks between two calls are not lost
+        movement->released |= buttons & ~report.buttons;
+        movement->overflow |= report.overflow;
+        buttons = report.buttons;
+        movement->packets++;
+    }
+    movement->dx = saturate16(dx);
+    movement->dy = saturate16(dy);
+    movement->wheel = saturate16(wheel);
+    movement->buttons = buttons;
+    return movement->packets ? TOUCHPAD_OK : TOUCHPAD_NO_DATA_TO_READ;
+}
+
+// reads one 6 byte Synaptics® packet
+static int8_t touchpad_readSynapticsPacket(uint8_t *p)
 {
     // this only works for Synaptics® devices
     if (touchpad_CurrentMode != eAbsoluteMode)
         return TOUCHPAD_WRONG_MODE_ERROR;
-    if (!ps2_isDataAvaiable(6))
+    if (touchpad_CommandActive || !touchpad_isPacketAvailable(6))
     {
         ps2_scheduleRx();
         return TOUCHPAD_NO_DATA_TO_READ;
     }
 
-    uint8_t dt1, dt2, dt3, dt4, dx, dy;
-    ps2_readByte(&dt1);
-    if ((dt1 & 0xC8) != 0x80) // verify if data is correct
+    ps2_readByte(&p[0]);
+    if ((p[0] & 0xC8) != 0x80) // verify if data is correct
         return TOUCHPAD_CORRUPT_DATA_ERROR;
-    ps2_readByte(&dt2);
-    ps2_readByte(&dt3);
-    ps2_readByte(&dt4);
-    if ((dt4 & 0xC8) != 0xC0) // verify if data is correct
+    ps2_readByte(&p[1]);
+    ps2_readByte(&p[2]);
+    ps2_readByte(&p[3]);
+    if ((p[3] & 0xC8) != 0xC0) // verify if data is correct
         return TOUCHPAD_CORRUPT_DATA_ERROR;
-    ps2_readByte(&dx);
-    ps2_readByte(&dy);
+    ps2_readByte(&p[4]);
+    ps2_readByte(&p[5]);
+    touchpad_stampPacket();
+    return TOUCHPAD_OK;
+}
+
+// W value is spread over bytes 1 and 4 of W mode packets
+static uint8_t touchpad_getW(const uint8_t *p)
+{
+    return ((p[0] & 0x30) >> 2) | ((p[0] & 0x04) >> 1) | ((p[3] & 0x04) >> 2);
+}
+
+static void touchpad_decodePosition(const uint8_t *p, touchpad_Contact *c)
+{
+    c->x = (uint16_t)p[4] | (uint16_t)(0x0F & p[1]) << 8 | (uint16_t)(p[3] & 0x10) << 8;
+    c->y = (uint16_t)p[5] | (uint16_t)(0xF0 & p[1]) << 4 | (uint16_t)(p[3] & 0x20) << 7;
+    c->z = p[2];
+    c->valid = (c->z != 0);
+}
+
+// extended W (W = 2) packet, with advanced gesture mode it holds the secondary finger at half resolution
+static void touchpad_storeExtendedPacket(const uint8_t *p)
+{
+    if ((touchpad_SynInfo.extCapabilities & SYN_EXTCAP_IMAGE_SENSOR) && (((p[5] & 0x30) >> 4) != 1))
+        return; // image sensors send other extended packet types too, only type 1 is a position
+    touchpad_Secondary.x = (uint16_t)(((p[4] & 0x0F) << 8) | p[1]) << 1;
+    touchpad_Secondary.y = (uint16_t)(((p[4] & 0xF0) << 4) | p[2]) << 1;
+    touchpad_Secondary.z = (uint8_t)(((p[3] & 0x30) | (p[5] & 0x0F)) << 1);
+    touchpad_Secondary.valid = true;
+}
+
+// pass-through (W = 3) packet encapsulates a 3 byte packet of the guest device (usually a TrackPoint)
+static void touchpad_storeGuestPacket(const uint8_t *p)
+{
+    if (((p[0] & 0xFC) != 0x84) || ((p[3] & 0xCC) != 0xC4))
+        return; // not a pass-through packet
+    if (touchpad_GuestAckPending)
+    {
+        touchpad_GuestAckPending = false;
+        if (p[1] == 0xFA)
+            return; // the guest's ACK has bit 3 set too, it's not movement
+    }
+    if (!(p[1] & 0x08))
+        return; // not a valid guest movement packet
+    uint8_t next = (touchpad_GuestIn + 1) % GUEST_QUEUE_SIZE;
+    if (next == touchpad_GuestOut)
+        return; // queue is full, drop data
+    touchpad_decodeMovement(p[1], p[4], p[5], &touchpad_GuestQueue[touchpad_GuestIn]);
+    touchpad_GuestQueue[touchpad_GuestIn].wheel = 0;
+    touchpad_GuestIn = next;
+}
+
+// reads one packet and sorts it by W, returns true for primary finger packets
+static int8_t touchpad_readDemuxedPacket(uint8_t *p, uint8_t *w, bool *primary)
+{
+    int8_t err = touchpad_readSynapticsPacket(p);
+    *primary = false;
+    if (err)
+        return err;
+    if (!(touchpad_SynModeByte & SYN_MODE_W))
+    {
+        *w = SYN_W_NARROW_FINGER; // no W in the packet, assume a single finger
+        *primary = true;
+        return TOUCHPAD_OK;
+    }
+    *w = touchpad_getW(p);
+    if (*w == 2)
+        touchpad_storeExtendedPacket(p);
+    else if (*w == 3)
+        touchpad_storeGuestPacket(p);
+    else
+        *primary = true;
+    return TOUCHPAD_OK;
+}
+
+// reads packets until one with the primary finger arrives
+static int8_t touchpad_readPrimaryPacket(uint8_t *p, uint8_t *w)
+{
+    int8_t err;
+    bool primary;
+    if (touchpad_PendingValid)
+    {
+        memcpy(p, touchpad_PendingPacket, sizeof(touchpad_PendingPacket));
+        *w = touchpad_PendingW;
+        touchpad_PendingValid = false;
+        return TOUCHPAD_OK;
+    }
+    while ((err = touchpad_readDemuxedPacket(p, w, &primary)) == TOUCHPAD_OK)
+        if (primary)
+            return TOUCHPAD_OK;
+    return err;
+}
+
+int8_t touchapd_readAbsolutePosition(uint16_t *px, uint16_t *py, uint8_t *pz)
+{
+    uint8_t p[6], w;
+    touchpad_Contact c;
+    int8_t err = touchpad_readPrimaryPacket(p, &w);
+    if (err)
+        return err;
+    touchpad_decodePosition(p, &c);
+    *px = c.x;
+    *py = c.y;
+    *pz = c.z;
+    return TOUCHPAD_OK;
+}
+
+int8_t touchpad_enablePassThrough()
+{
+    touchpad_SynapticsInfo info;
+    int8_t err = touchpad_querySynaptics(&info);
+    if (err)
+        return err;
+    if (!(info.capabilities & SYN_CAP_PASS_THROUGH))
+        return TOUCHPAD_NOT_SUPPORTED;
+
+    if (!(touchpad_SynModeByte & SYN_MODE_W) || (touchpad_CurrentMode != eAbsoluteMode))
+    {
+        // guest packets are only recognizable by W, keep the rest of the current setup
+        touchpad_SynapticsMode mode = {
+            .absolute = true,
+            .highRate = ((touchpad_SynModeByte & SYN_MODE_HIGH_RATE) != 0),
+            .wMode = true};
+        err = touchpad_setSynapticsMode(&mode);
+        if (err)
+            return err;
+    }
+
+    uint8_t sequence[10];
+    touchpad_encodeSliced(0xF4, sequence); // Enable Data Reporting for the guest...
+    sequence[8] = 0xF3;                    // ...Set Sample Rate 40 after a sliced byte forwards it to the guest
+    sequence[9] = 0x28;
+    touchpad_GuestIn = touchpad_GuestOut = 0;
+    err = touchpad_runCommands(sequence, sizeof(sequence), NULL, 0);
+    touchpad_GuestAckPending = (err == TOUCHPAD_OK); // arrives later, as the first pass-through packet
+    return err;
+}
+
+// guest packets are picked up by all absolute mode readers, so call this
+// together with touchapd_readAbsolutePosition() or touchpad_readContacts()
+int8_t touchpad_readGuestMovement(touchpad_MouseReport *report)
+{
+    if ((touchpad_GuestIn == touchpad_GuestOut) && !touchpad_PendingValid)
+    {
+        bool primary;
+        int8_t err = touchpad_readDemuxedPacket(touchpad_PendingPacket, &touchpad_PendingW, &primary);
+        if (err)
+            return err;
+        touchpad_PendingValid = primary; // keep it for the primary finger readers
+    }
+    if (touchpad_GuestIn == touchpad_GuestOut)
+        return TOUCHPAD_NO_DATA_TO_READ;
+    *report = touchpad_GuestQueue[touchpad_GuestOut];
+    touchpad_GuestOut = (touchpad_GuestOut + 1) % GUEST_QUEUE_SIZE;
+    return TOUCHPAD_OK;
+}
+
+void touchpad_setPointerConfig(const touchpad_PointerConfig *config)
+{
+    touchpad_Pointer = *config;
+    if (touchpad_Pointer.divider == 0)
+        touchpad_Pointer.divider = 1;
+    if (touchpad_Pointer.accelThreshold == 0)
+        touchpad_Pointer.accelThreshold = 1;
+    if (touchpad_Pointer.maxGain == 0)
+        touchpad_Pointer.maxGain = 1; // 0 would stop the pointer, 1 is no acceleration
+    touchpad_PtrTouching = false;
+}
+
+// scales one axis by the Q8 gain and the divider, keeping the remainder for the next packet
+static int16_t touchpad_scaleDelta(int32_t delta, int32_t gain, int32_t *remainder)
+{
+    int32_t den = 256 * (int32_t)touchpad_Pointer.divider;
+    int32_t v = delta * gain + *remainder;
+    int32_t out = v / den;
+    *remainder = v - out * den;
+    return saturate16(out);
+}
+
+int8_t touchpad_readVirtualMovement(int16_t *px, int16_t *py, bool *button)
+{
+    uint8_t p[6], w;
+    touchpad_Contact c;
+    int8_t err = touchpad_readPrimaryPacket(p, &w);
+    if (err)
+        return err;
+    touchpad_decodePosition(p, &c);
+    *px = *py = 0;
+    if (button)
+        *button = ((p[0] & TOUCHPAD_BUTTON_LEFT) == TOUCHPAD_BUTTON_LEFT);
+
+    bool multi = (w < 2); // W = 0 or 1: the reported point jumps between fingers
+    if ((c.z < touchpad_Pointer.touchZ) || multi || ((touchpad_PtrLastW < 2) != multi))
+    {
+        touchpad_PtrTouching = false; // lifted, the next touch starts from scratch
+        touchpad_PtrLastW = w;
+        return TOUCHPAD_OK;
+    }
+    touchpad_PtrLastW = w;
+    if (!touchpad_PtrTouching) // landing, remember where and don't move the cursor
+    {
+        touchpad_PtrTouching = true;
+        touchpad_PtrLastX = c.x;
+        touchpad_PtrLastY = c.y;
+        touchpad_PtrRemX = touchpad_PtrRemY = 0;
+        touchpad_PtrSettle = touchpad_Pointer.landPackets;
+        return TOUCHPAD_OK;
+    }
+
+    int32_t dx = (int32_t)c.x - touchpad_PtrLastX;
+    int32_t dy = (int32_t)c.y - touchpad_PtrLastY;
+    touchpad_PtrLastX = c.x;
+    touchpad_PtrLastY = c.y;
+    if (touchpad_PtrSettle) // first positions after landing are unstable
+    {
+        touchpad_PtrSettle--;
+        return TOUCHPAD_OK;
+    }
+
+    // gain grows linearly with speed above the threshold, Q8 fixed point
+    int32_t speed = ((dx < 0) ? -dx : dx) + ((dy < 0) ? -dy : dy);
+    int32_t gain = 256;
+    if (speed > touchpad_Pointer.accelThreshold)
+        gain += ((speed - touchpad_Pointer.accelThreshold) * touchpad_Pointer.accelGain * 256) / touchpad_Pointer.accelThreshold / 16;
+    if (gain > 256 * (int32_t)touchpad_Pointer.maxGain)
+        gain = 256 * (int32_t)touchpad_Pointer.maxGain;
+
+    *px = touchpad_scaleDelta(dx, gain, &touchpad_PtrRemX);
+    *py = touchpad_scaleDelta(dy, gain, &touchpad_PtrRemY);
+    return TOUCHPAD_OK;
+}
+
+int8_t touchpad_enableMultiFinger()
+{
+    touchpad_SynapticsInfo info;
+    int8_t err = touchpad_querySynaptics(&info);
+    if (err)
+        return err;
+    if (!(info.extCapabilities & SYN_EXTCAP_ADV_GESTURE))
+        return TOUCHPAD_NOT_SUPPORTED;
+
+    touchpad_SynapticsMode mode = {
+        .absolute = true,
+        .highRate = ((touchpad_SynModeByte & SYN_MODE_HIGH_RATE) != 0),
+        .wMode = true,
+        .extendedW = true};
+    err = touchpad_setSynapticsMode(&mode);
+    if (err)
+        return err;
+
+    uint8_t sequence[10];
+    touchpad_encodeSliced(0x03, sequence);
+    sequence[8] = 0xF3; // Set Sample Rate 200 after the sliced 0x03 turns on advanced gesture mode
+    sequence[9] = 0xC8;
+    touchpad_Secondary.valid = false;
+    return touchpad_runCommands(sequence, sizeof(sequence), NULL, 0);
+}
+
+int8_t touchpad_readContacts(touchpad_ContactFrame *frame)
+{
+    uint8_t p[6], w;
+    int8_t err = touchpad_readPrimaryPacket(p, &w);
+    if (err)
+        return err;
+
+    touchpad_decodePosition(p, &frame->contact[0]);
+    frame->w = w;
+    frame->buttons = p[0] & (TOUCHPAD_BUTTON_LEFT | TOUCHPAD_BUTTON_RIGHT);
+    if (!frame->contact[0].valid)
+        frame->fingers = 0;
+    else if (w == 0)
+        frame->fingers = 2;
+    else if (w == 1)
+        frame->fingers = 3; // or more
+    else
+        frame->fingers = 1;
 
-    *px = (uint16_t)dx | (uint16_t)(0x0F & dt2) << 8 | (uint16_t)(dt4 & 0x10) << 8;
-    *py = (uint16_t)dy | (uint16_t)(0xF0 & dt2) << 4 | (uint16_t)(dt4 & 0x20) << 7;
-    *pz = dt3;
+    if (frame->fingers < 2)
+        touchpad_Secondary.valid = false; // the second finger is gone
+    frame->contact[1] = touchpad_Secondary;
     return TOUCHPAD_OK;
 }
@@ -11,10 +11,12 @@
 #include <stddef.h>
 
 #define TOUCHPAD_OK (0)
+#define TOUCHPAD_BUSY (1)                 // not an error: command transaction in progress, call touchpad_processCommands()
 #define TOUCHPAD_NO_DATA_TO_READ (-1)     // FIFO empty, no new data has been received (happens often)
 #define TOUCHPAD_CORRUPT_DATA_ERROR (-2)  // data from touchapd is not correct (happens rarely)
 #define TOUCHPAD_WRONG_MODE_ERROR (-7)    // please set correct mode to read data (should never happen)
 #define TOUCHPAD_SET_MODE_FAILED (-8)     // touchpad not responding correctly (should never happen)
+#define TOUCHPAD_NOT_SUPPORTED (-9)       // requested feature is not reported in the device capabilities
 
 typedef enum // possible modes of the device
 {
@@ -23,6 +25,124 @@ typedef enum // possible modes of the device
     eAbsoluteMode   // Synaptics® absolute position mode
 } touchapd_Mode;
 
+typedef enum // device ID reported by the 0xF2 command
+{
+    eStandardMouse = 0x00,  // 3 byte packets, 3 buttons
+    eWheelMouse = 0x03,     // IntelliMouse: 4 byte packets with scroll wheel
+    eFiveButtonMouse = 0x04 // IntelliMouse Explorer: 4 byte packets with scroll wheel and 5 buttons
+} touchpad_DeviceType;
+
+#define TOUCHPAD_BUTTON_LEFT   (0x01)
+#define TOUCHPAD_BUTTON_RIGHT  (0x02)
+#define TOUCHPAD_BUTTON_MIDDLE (0x04)
+#define TOUCHPAD_BUTTON_4      (0x08) // only eFiveButtonMouse
+#define TOUCHPAD_BUTTON_5      (0x10) // only eFiveButtonMouse
+
+typedef struct // one decoded relative mode packet
+{
+    int16_t dx;
+    int16_t dy;
+    int8_t wheel;    // always 0 for eStandardMouse
+    uint8_t buttons; // TOUCHPAD_BUTTON_* bit mask
+    bool overflow;   // movement was too fast, dx/dy are saturated to -256 or 255
+} touchpad_MouseReport;
+
+typedef struct // all relative mode packets merged by touchpad_readAccumulatedMovement()
+{
+    int16_t dx;       // net movement since the previous call
+    int16_t dy;
+    int16_t wheel;
+    uint8_t buttons;  // current state, TOUCHPAD_BUTTON_* bit mask
+    uint8_t pressed;  // buttons that went down since the previous call
+    uint8_t released; // buttons that went up since the previous call
+    uint8_t packets;  // number of merged packets
+    bool overflow;    // at least one of the packets was saturated
+} touchpad_Movement;
+
+typedef enum // who decides when packets are sent
+{
+    eStreamReporting, // device sends packets at its own sample rate (default after init)
+    eRemoteReporting  // device sends a packet only when asked by touchpad_remotePoll()
+} touchpad_ReportingMode;
+
+typedef enum // counts per millimeter in relative mode
+{
+    eResolution1cpmm = 0,
+    eResolution2cpmm = 1,
+    eResolution4cpmm = 2, // default after init
+    eResolution8cpmm = 3
+} touchpad_Resolution;
+
+typedef enum // relative mode scaling, values are the command codes
+{
+    eScaling1to1 = 0xE6, // default after init
+    eScaling2to1 = 0xE7  // device applies its acceleration curve to the movement
+} touchpad_Scaling;
+
+typedef struct // reply of the Status Request command
+{
+    bool remoteMode;
+    bool enabled; // data reporting enabled
+    touchpad_Scaling scaling;
+    touchpad_Resolution resolution;
+    uint8_t sampleRate;
+    uint8_t buttons; // TOUCHPAD_BUTTON_* bit mask
+} touchpad_Status;
+
+typedef struct // Synaptics® mode byte, see touchpad_setSynapticsMode()
+{
+    bool absolute;        // absolute position packets instead of relative movement
+    bool highRate;        // 80 packets/s instead of 40
+    bool disableGestures; // no tap and drag detection in the device firmware (not with wMode)
+    bool wMode;           // packets carry the W value (finger width / count)
+    bool extendedW;       // extended W packets, like the secondary finger (needs wMode)
+} touchpad_SynapticsMode;
+
+typedef struct // Synaptics® identification and capabilities
+{
+    bool isSynaptics;
+    uint8_t majorVersion;
+    uint8_t minorVersion;
+    uint32_t capabilities;    // SYN_CAP_* bits
+    uint32_t extCapabilities; // SYN_EXTCAP_* bits, 0 if the device has no 0x0C query
+} touchpad_SynapticsInfo;
+
+#define SYN_CAP_EXTENDED        (1UL << 23)
+#define SYN_CAP_MIDDLE_BUTTON   (1UL << 18)
+#define SYN_CAP_PASS_THROUGH    (1UL << 7)
+#define SYN_CAP_FOUR_BUTTON     (1UL << 3)
+#define SYN_CAP_MULTIFINGER     (1UL << 1)
+#define SYN_CAP_PALM_DETECT     (1UL << 0)
+#define SYN_EXTCAP_CLICKPAD     (1UL << 20)
+#define SYN_EXTCAP_ADV_GESTURE  (1UL << 19)
+#define SYN_EXTCAP_IMAGE_SENSOR (1UL << 11)
+
+typedef struct // one finger in absolute mode
+{
+    uint16_t x; // same range as touchapd_readAbsolutePosition()
+    uint16_t y;
+    uint8_t z;
+    bool valid;
+} touchpad_Contact;
+
+typedef struct // result of touchpad_readContacts()
+{
+    touchpad_Contact contact[2]; // primary and secondary finger (secondary has half the resolution)
+    uint8_t fingers;             // 0, 1, 2 or 3 (means 3 or more)
+    uint8_t w;                   // W of the primary packet, 4..15 is the finger width
+    uint8_t buttons;             // TOUCHPAD_BUTTON_* bit mask
+} touchpad_ContactFrame;
+
+typedef struct // absolute to relative conversion used by touchpad_readVirtualMovement()
+{
+    uint16_t divider;        // absolute units per output count at low speed
+    uint16_t accelThreshold; // speed [absolute units per packet] above which acceleration starts
+    uint8_t accelGain;       // gain increase per accelThreshold of extra speed, in 1/16
+    uint8_t maxGain;         // acceleration limit (1 = no acceleration)
+    uint8_t touchZ;          // pz below this value is a lifted finger
+    uint8_t landPackets;     // packets ignored after a new touch
+} touchpad_PointerConfig;
+
 typedef enum // possible datarates to select
 {
     eSampleRate10fps = 10,
@@ -34,12 +154,45 @@ typedef enum // possible datarates to select
     eSampleRate200fps = 200
 } touchpad_SampleRate;
 
+typedef struct // relative mode settings applied by touchpad_beginConfig()
+{
+    touchpad_Resolution resolution;
+    touchpad_Scaling scaling;
+    touchpad_SampleRate sampleRate;
+} touchpad_Config;
+
+#define TOUCHPAD_MAX_COMMAND_BYTES 16 // longest transaction touchpad_beginCommands() accepts
+
 int8_t touchapd_init();
-int8_t touchpad_setMode(touchapd_Mode mode);
+int8_t touchpad_setMode(touchapd_Mode mode);                                   // resets the device only if needed, TOUCHPAD_BUSY during a transaction
+uint32_t touchpad_getModeSwitchTime();                                         // [ms] duration of the last touchpad_setMode()
 touchapd_Mode touchpad_getCurrentMode();
+touchpad_DeviceType touchpad_getDeviceType();                                   // detected during touchapd_init()
 int8_t touchapd_setSampleRate(touchpad_SampleRate value);                      // (not all devices support this)
+int8_t touchpad_setReportingMode(touchpad_ReportingMode mode);                 // touchapd_init() restores eStreamReporting
+touchpad_ReportingMode touchpad_getReportingMode();
+void touchpad_remotePoll();                                                    // call from a timer interrupt, touchpad_processCommands() sends the poll
+uint32_t touchpad_getPacketTimestamp();                                        // [ms] when the last read packet was sampled
+int8_t touchpad_beginConfig(const touchpad_Config *config);                    // non-blocking, all settings in one transaction
+int8_t touchpad_readStatus(touchpad_Status *status);
+
+// Non-blocking command path: bytes are sent one by one as their ACKs arrive,
+// response_len bytes following the last ACK are stored in response.
+// Packet reading is paused (TOUCHPAD_NO_DATA_TO_READ) until the transaction ends.
+int8_t touchpad_beginCommands(const uint8_t *bytes, uint8_t count, uint8_t *response, uint8_t response_len);
+int8_t touchpad_processCommands(); // TOUCHPAD_BUSY until the transaction is done, then its result
 int8_t touchapd_readMovement(int16_t *px, int16_t *py, bool *button);          // needs to be called frequently
+int8_t touchpad_readMouseReport(touchpad_MouseReport *report);                 // same as above, with all buttons and the wheel
+int8_t touchpad_readAccumulatedMovement(touchpad_Movement *movement);          // all pending packets at once, call once per frame
 int8_t touchapd_readAbsolutePosition(uint16_t *px, uint16_t *py, uint8_t *pz); // this only works for Synaptics® devices
+int8_t touchpad_querySynaptics(touchpad_SynapticsInfo *info);                  // result is cached until touchapd_init()
+int8_t touchpad_setSynapticsMode(const touchpad_SynapticsMode *mode);          // validated against the capabilities
+int8_t touchpad_enableMultiFinger();                                           // absolute + W mode + advanced gesture mode, repeat after a reset
+int8_t touchpad_readContacts(touchpad_ContactFrame *frame);                    // both fingers, best with touchpad_enableMultiFinger()
+int8_t touchpad_readVirtualMovement(int16_t *px, int16_t *py, bool *button);   // touchapd_readMovement() computed from absolute mode
+void touchpad_setPointerConfig(const touchpad_PointerConfig *config);
+int8_t touchpad_enablePassThrough();                                           // absolute + W mode and guest device (TrackPoint) reporting
+int8_t touchpad_readGuestMovement(touchpad_MouseReport *report);               // relative movement of the guest device
 
 //                              px         py
 // Absolute reportable limits  0–6143     0–6143
@@ -0,0 +1,168 @@
+//  Virtual buttons and sliders for the PS/2 Touchpad Driver
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#include "zones.h"
+
+// device units that lookup() puts into cell n, one unit wider on both sides against rounding
+static void cellRange(uint16_t min, uint32_t scale, uint8_t n, uint8_t cells, uint32_t *first, uint32_t *last)
+{
+    uint32_t lo = min + (((uint32_t)n << 16) / scale);
+    uint32_t hi = min + (((uint32_t)(n + 1) << 16) / scale) + 1;
+    *first = (n == 0) ? 0 : lo - 1; // the first and last cells also take everything outside the surface
+    *last = (n == cells - 1) ? UINT16_MAX : hi;
+}
+
+bool zones_compile(zones_Map *map, const zones_Rect *rects, uint8_t count,
+                   uint16_t x_min, uint16_t y_min, uint16_t x_max, uint16_t y_max)
+{
+    if ((count > ZONES_MAX) || (x_max <= x_min) || (y_max <= y_min))
+        return false;
+    for (uint8_t i = 0; i < count; i++)
+        if (rects[i].id == ZONES_NONE) // zones_hitTest() couldn't tell it from the uncovered surface
+            return false;
+
+    map->count = count;
+    map->xMin = x_min;
+    map->yMin = y_min;
+    // one past the last cell maps to ZONES_GRID_COLS, the lookup clamps it
+    map->scaleX = ((uint32_t)ZONES_GRID_COLS << 16) / (x_max - x_min + 1u);
+    map->scaleY = ((uint32_t)ZONES_GRID_ROWS << 16) / (y_max - y_min + 1u);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        map->rect[i] = rects[i];
+        uint32_t span = 0;
+        if (rects[i].kind == eZoneSliderX)
+            span = rects[i].xMax - rects[i].xMin;
+        else if (rects[i].kind == eZoneSliderY)
+            span = rects[i].yMax - rects[i].yMin;
+        map->sliderScale[i] = span ? (255u << 16) / span : 0;
+    }
+
+    // every cell lists all rectangles touching it, a rectangle thinner than a cell is never lost
+    for (uint8_t r = 0; r < ZONES_GRID_ROWS; r++)
+    {
+        uint32_t y1, y2;
+        cellRange(map->yMin, map->scaleY, r, ZONES_GRID_ROWS, &y1, &y2);
+        for (uint8_t c = 0; c < ZONES_GRID_COLS; c++)
+        {
+            uint32_t x1, x2;
+            cellRange(map->xMin, map->scaleX, c, ZONES_GRID_COLS, &x1, &x2);
+            map->cell[r][c] = 0;
+            for (uint8_t i = 0; i < count; i++)
+                if ((rects[i].xMin <= x2) && (rects[i].xMax >= x1) && (rects[i].yMin <= y2) && (rects[i].yMax >= y1))
+                    map->cell[r][c] |= (uint16_t)(1u << i);
+        }
+    }
+    return true;
+}
+
+static uint8_t lookup(const zones_Map *map, uint16_t x, uint16_t y)
+{
+    uint32_t c = (x > map->xMin) ? (((uint32_t)(x - map->xMin) * map->scaleX) >> 16) : 0;
+    uint32_t r = (y > map->yMin) ? (((uint32_t)(y - map->yMin) * map->scaleY) >> 16) : 0;
+    if (c >= ZONES_GRID_COLS)
+        c = ZONES_GRID_COLS - 1;
+    if (r >= ZONES_GRID_ROWS)
+        r = ZONES_GRID_ROWS - 1;
+
+    // candidates in list order, the first rectangle containing the point wins
+    uint16_t candidates = map->cell[r][c];
+    for (uint8_t i = 0; candidates; i++, candidates >>= 1)
+    {
+        const zones_Rect *rect = &map->rect[i];
+        if ((candidates & 1u) && (x >= rect->xMin) && (x <= rect->xMax) && (y >= rect->yMin) && (y <= rect->yMax))
+            return i;
+    }
+    return ZONES_NONE;
+}
+
+uint8_t zones_hitTest(const zones_Map *map, uint16_t x, uint16_t y)
+{
+    uint8_t zone = lookup(map, x, y);
+    return (zone == ZONES_NONE) ? ZONES_NONE : map->rect[zone].id;
+}
+
+static uint8_t sliderValue(const zones_Map *map, uint8_t zone, uint16_t x, uint16_t y)
+{
+    const zones_Rect *rect = &map->rect[zone];
+    int32_t pos;
+    if (rect->kind == eZoneSliderX)
+        pos = (int32_t)x - rect->xMin;
+    else if (rect->kind == eZoneSliderY)
+        pos = (int32_t)y - rect->yMin;
+    else
+        return 0;
+    if (pos <= 0)
+        return 0;
+    uint32_t value = ((uint32_t)pos * map->sliderScale[zone]) >> 16;
+    return (value > 255) ? 255 : (uint8_t)value;
+}
+
+void zones_setMap(zones_Tracker *tracker, const zones_Map *map)
+{
+    tracker->map = map;
+    tracker->zone = ZONES_NONE;
+    tracker->pressed = ZONES_NONE;
+    tracker->value = 0;
+    tracker->touching = false;
+}
+
+void zones_init(zones_Tracker *tracker, const zones_Map *map)
+{
+    zones_setMap(tracker, map);
+}
+
+static void addEvent(zones_Event *events, uint8_t *n, zones_EventType type, uint8_t id, uint8_t value)
+{
+    events[*n].type = type;
+    events[*n].id = id;
+    events[*n].value = value;
+    (*n)++;
+}
+
+uint8_t zones_update(zones_Tracker *tracker, uint16_t x, uint16_t y, bool touching,
+                     zones_Event events[ZONES_MAX_EVENTS])
+{
+    const zones_Map *map = tracker->map;
+    uint8_t n = 0;
+    if (map == NULL)
+        return 0;
+
+    uint8_t zone = touching ? lookup(map, x, y) : ZONES_NONE;
+
+    if (!touching && tracker->touching && (tracker->pressed != ZONES_NONE))
+    {
+        addEvent(events, &n, eZoneRelease, map->rect[tracker->pressed].id, 0);
+        tracker->pressed = ZONES_NONE;
+    }
+    if (zone != tracker->zone)
+    {
+        if (tracker->zone != ZONES_NONE)
+            addEvent(events, &n, eZoneLeave, map->rect[tracker->zone].id, 0);
+        if (zone != ZONES_NONE && tracker->touching)
+            addEvent(events, &n, eZoneEnter, map->rect[zone].id, 0);
+    }
+
+    if (zone != ZONES_NONE)
+    {
+        uint8_t value = sliderValue(map, zone, x, y);
+        bool slider = (map->rect[zone].kind == eZoneSliderX) || (map->rect[zone].kind == eZoneSliderY);
+        if (!tracker->touching) // touch down
+        {
+            tracker->pressed = zone;
+            addEvent(events, &n, eZonePress, map->rect[zone].id, value);
+        }
+        else if (slider && ((value != tracker->value) || (zone != tracker->zone)))
+        {
+            addEvent(events, &n, eZoneSlide, map->rect[zone].id, value);
+        }
+        tracker->value = value;
+    }
+
+    tracker->zone = zone;
+    tracker->touching = touching;
+    return n;
+}
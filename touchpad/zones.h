@@ -0,0 +1,86 @@
+//  Virtual buttons and sliders for the PS/2 Touchpad Driver
+//
+// The surface is split into rectangles given in device (absolute mode)
+// coordinates. zones_compile() turns them into a coarse grid lookup table,
+// so every packet is resolved with two multiplications, one table read and
+// an exact test against the few rectangles overlapping that grid cell.
+//
+// Copyright (c) 2019 by ppelikan
+// github.com/ppelikan
+
+#ifndef __ZONES_H__
+#define __ZONES_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define ZONES_GRID_COLS 32 // zones smaller than a cell still hit exactly, they only share the cell
+#define ZONES_GRID_ROWS 32
+#define ZONES_MAX 16       // rectangles per map, one bit each in the cell masks
+#define ZONES_NONE 0xFF    // zone id of the uncovered surface
+#define ZONES_MAX_EVENTS 3 // zones_update() never reports more events per packet
+
+typedef enum
+{
+    eZoneButton,  // press and release only
+    eZoneSliderX, // reports position along X (left = 0)
+    eZoneSliderY, // reports position along Y (bottom = 0)
+    eZoneArea     // press and release, the application reads the position itself (e.g. cursor area)
+} zones_Kind;
+
+typedef struct
+{
+    uint16_t xMin, yMin; // inclusive
+    uint16_t xMax, yMax; // inclusive
+    uint8_t id;          // reported in the events, anything but ZONES_NONE
+    zones_Kind kind;
+} zones_Rect;
+
+typedef struct // build it with zones_compile(), one map per layout, usually static
+{
+    zones_Rect rect[ZONES_MAX];
+    uint8_t count;
+    uint16_t xMin, yMin;      // surface extent
+    uint32_t scaleX, scaleY;  // [Q16] device units to grid cells
+    uint32_t sliderScale[ZONES_MAX]; // [Q16] device units to slider value
+    uint16_t cell[ZONES_GRID_ROWS][ZONES_GRID_COLS]; // bit i set: rect[i] overlaps the cell
+} zones_Map;
+
+typedef enum
+{
+    eZoneNoEvent,
+    eZoneEnter,   // finger on the surface moved into the zone
+    eZoneLeave,   // finger moved out of the zone or was lifted
+    eZonePress,   // touch started inside the zone
+    eZoneRelease, // touch that started inside the zone ended
+    eZoneSlide    // new slider position (the press carries the initial one)
+} zones_EventType;
+
+typedef struct
+{
+    zones_EventType type;
+    uint8_t id;     // zones_Rect.id
+    uint8_t value;  // slider position 0..255, 0 for other kinds
+} zones_Event;
+
+typedef struct // treat as opaque
+{
+    const zones_Map *map;
+    uint8_t zone;    // index into map->rect[], ZONES_NONE if outside
+    uint8_t pressed; // index of the pressed zone, ZONES_NONE if none
+    uint8_t value;   // last reported slider value
+    bool touching;
+} zones_Tracker;
+
+// Rectangles listed first win where they overlap. Returns false for an empty surface,
+// too many rectangles or a rectangle with the id ZONES_NONE.
+bool zones_compile(zones_Map *map, const zones_Rect *rects, uint8_t count,
+                   uint16_t x_min, uint16_t y_min, uint16_t x_max, uint16_t y_max);
+void zones_init(zones_Tracker *tracker, const zones_Map *map);
+void zones_setMap(zones_Tracker *tracker, const zones_Map *map); // safe at any time, the current touch is forgotten
+uint8_t zones_hitTest(const zones_Map *map, uint16_t x, uint16_t y); // returns zones_Rect.id or ZONES_NONE
+uint8_t zones_update(zones_Tracker *tracker, uint16_t x, uint16_t y, bool touching,
+                     zones_Event events[ZONES_MAX_EVENTS]); // returns number of events written
+
+#endif